@@ -0,0 +1,116 @@
+#include "AllocTracker.h"
+#include "Bench.h"
+#include "BotPolicy.h"
+#include "BuildSpec.h"
+#include "BulletPattern.h"
+#include "GameWorld.h"
+#include "Profiler.h"
+#include "raylib.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int BENCH_WIDTH = 1600;
+const int BENCH_HEIGHT = 1200;
+const float BENCH_TICK = 1.0f / 60.0f;
+const float WARMUP_SECONDS = 5.0f;
+
+} // namespace
+
+// Plays a build headless with the game's waves and patterns and counts
+// heap allocations per tick once it has warmed up, sampling every
+// allocation's callstack. With a limit, fails if any tick allocates more.
+int RunAllocBench(int argc, char **argv) {
+  if (!AllocTracker::IsEnabled()) {
+    fprintf(stderr, "allocs: needs a build configured with "
+                    "-DRRL_ALLOC_TRACKING=ON\n");
+    return 1;
+  }
+  std::string buildPath =
+      argc > 0 ? argv[0] : ASSETS_PATH "builds/fire_shield.txt";
+  float seconds = argc > 1 ? (float)atof(argv[1]) : 60.0f;
+  long long limit = argc > 2 ? atoll(argv[2]) : -1;
+  if (seconds <= 0.0f) {
+    fprintf(stderr, "allocs: duration must be positive\n");
+    return 1;
+  }
+  SetTraceLogLevel(LOG_WARNING);
+
+  BuildSpec spec;
+  if (!LoadBuildSpec(buildPath, spec))
+    return 1;
+  GameWorld world(BENCH_WIDTH, BENCH_HEIGHT);
+  Profiler profiler;
+  world.SetProfiler(&profiler);
+  std::vector<BulletPattern> patterns;
+  if (LoadBulletPatterns(ASSETS_PATH "patterns.txt", patterns))
+    world.SetBulletPatterns(patterns);
+  world.LoadWaves(ASSETS_PATH "waves.txt");
+  world.Seed(1);
+  world.Init();
+  if (!ApplyBuildSpec(spec, world))
+    return 1;
+  world.state = GameState::GAMEPLAY;
+
+  auto tick = [&]() {
+    world.Tick(DecideBotInput(spec.policy, world), BENCH_TICK);
+    return world.state == GameState::GAMEPLAY;
+  };
+  bool alive = true;
+  while (alive && world.GetStats().elapsed < WARMUP_SECONDS)
+    alive = tick();
+
+  // Count from here on
+  AllocTracker::TakeTotals();
+  for (int i = 0; i < (int)ProfileZone::COUNT; i++)
+    AllocTracker::TakeZone(i);
+  AllocTracker::ClearSites();
+  AllocTracker::SetSampleInterval(1);
+
+  int ticks = 0;
+  int allocatingTicks = 0;
+  AllocCounts sum = {};
+  uint64_t maxAllocations = 0;
+  float end = WARMUP_SECONDS + seconds;
+  while (alive && world.GetStats().elapsed < end) {
+    alive = tick();
+    AllocCounts counts = AllocTracker::TakeTotals();
+    ticks++;
+    allocatingTicks += counts.allocations > 0 ? 1 : 0;
+    sum.allocations += counts.allocations;
+    sum.bytes += counts.bytes;
+    if (counts.allocations > maxAllocations)
+      maxAllocations = counts.allocations;
+  }
+  AllocTracker::SetSampleInterval(0);
+  if (ticks == 0) {
+    fprintf(stderr, "allocs: the run ended during the warm-up\n");
+    return 1;
+  }
+
+  printf("allocs: %s, %d ticks after a %.0f s warm-up%s\n", buildPath.c_str(),
+         ticks, WARMUP_SECONDS, alive ? "" : " (the run ended early)");
+  printf("  per tick: %.2f allocations, %.1f bytes, max %llu\n",
+         (double)sum.allocations / ticks, (double)sum.bytes / ticks,
+         (unsigned long long)maxAllocations);
+  printf("  ticks that allocated: %d (%.1f%%)\n", allocatingTicks,
+         100.0 * allocatingTicks / ticks);
+  for (int i = 0; i < (int)ProfileZone::COUNT; i++) {
+    AllocCounts zone = AllocTracker::TakeZone(i);
+    if (zone.allocations > 0)
+      printf("  %-18s %8.2f allocations per tick\n",
+             GetProfileZoneName((ProfileZone)i),
+             (double)zone.allocations / ticks);
+  }
+  AllocTracker::PrintTopSites(stdout, 5);
+
+  if (limit >= 0 && (long long)maxAllocations > limit) {
+    printf("FAIL: a tick made %llu allocations, limit %lld\n",
+           (unsigned long long)maxAllocations, limit);
+    return 1;
+  }
+  return 0;
+}
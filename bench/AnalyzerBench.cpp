@@ -0,0 +1,144 @@
+#include "Bench.h"
+#include "BuildAnalyzer.h"
+#include "BuildSpec.h"
+#include "GameWorld.h"
+#include "raylib.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const int BENCH_WIDTH = 1600;
+const int BENCH_HEIGHT = 1200;
+const float BENCH_TICK = 1.0f / 60.0f;
+const float TOLERANCE = 0.02f; // Relative, or absolute for uptimes
+
+struct AnalyzerCase {
+  const char *name;
+  BuildSpec spec;
+};
+
+BuildSpec MakeSpec(std::vector<BuildSpec::Node> nodes,
+                   std::vector<BuildSpec::Link> links) {
+  BuildSpec spec;
+  spec.policy = BotPolicy::IDLE;
+  spec.nodes = std::move(nodes);
+  spec.links = std::move(links);
+  return spec;
+}
+
+std::vector<AnalyzerCase> MakeCases() {
+  return {
+      {"fire", MakeSpec({{"gun", NodeType::ACTION_FIRE}}, {{"cpu", "gun"}})},
+      {"fire+shield",
+       MakeSpec({{"gun", NodeType::ACTION_FIRE},
+                 {"wall", NodeType::ACTION_SHIELD},
+                 {"haste", NodeType::POWER_DURATION_REDUCE},
+                 {"hp", NodeType::STAT_HEALTH}},
+                {{"cpu", "gun"},
+                 {"gun", "wall"},
+                 {"wall", "gun"},
+                 {"cpu", "haste"},
+                 {"haste", "gun"},
+                 {"cpu", "hp"},
+                 {"hp", "wall"}})},
+      {"shift->fire",
+       MakeSpec({{"dash", NodeType::ACTION_SHIFT},
+                 {"gun", NodeType::ACTION_FIRE},
+                 {"fast", NodeType::STAT_SPEED},
+                 {"dmg", NodeType::STAT_DAMAGE},
+                 {"boost", NodeType::POWER_VALUE_ADD}},
+                {{"cpu", "dash"},
+                 {"dash", "gun"},
+                 {"cpu", "fast"},
+                 {"fast", "dash"},
+                 {"cpu", "dmg"},
+                 {"dmg", "gun"},
+                 {"cpu", "boost"},
+                 {"boost", "gun"}})},
+  };
+}
+
+bool Close(float predicted, float measured, bool absolute) {
+  float error = fabsf(predicted - measured);
+  if (!absolute && measured != 0.0f)
+    error /= fabsf(measured);
+  return error <= TOLERANCE;
+}
+
+} // namespace
+
+// Checks BuildAnalyzer's closed-form figures against a headless run of the
+// same build, and times both
+int RunAnalyzerBench(int argc, char **argv) {
+  float seconds = argc > 0 ? (float)atof(argv[0]) : 300.0f;
+  if (seconds <= 0.0f) {
+    fprintf(stderr, "analyzer: duration must be positive\n");
+    return 1;
+  }
+  SetTraceLogLevel(LOG_WARNING);
+
+  printf("%.0f s per build, tolerance %.0f%%\n", seconds, TOLERANCE * 100);
+  printf("  %-12s %-14s %10s %10s\n", "build", "figure", "analytic",
+         "simulated");
+
+  bool allMatch = true;
+  for (const AnalyzerCase &analyzerCase : MakeCases()) {
+    GameWorld world(BENCH_WIDTH, BENCH_HEIGHT);
+    world.Seed(1);
+    world.Init();
+    if (!ApplyBuildSpec(analyzerCase.spec, world))
+      return 1;
+
+    BenchTimer analyzeTimer;
+    const int analyzeRepeats = 1000;
+    BuildEstimate estimate = {};
+    for (int i = 0; i < analyzeRepeats; i++)
+      estimate = AnalyzeBuild(world.player, world.nodesController, BENCH_TICK);
+    double analyzeUs = analyzeTimer.ElapsedMs() * 1000.0 / analyzeRepeats;
+
+    // Sample the tick's own outputs: shield flag and speed after every tick
+    world.state = GameState::GAMEPLAY;
+    PlayerInput input = {};
+    int shieldedTicks = 0;
+    double speedSum = 0.0;
+    int ticks = 0;
+    BenchTimer simulateTimer;
+    while (world.GetStats().elapsed < seconds) {
+      world.Tick(input, BENCH_TICK);
+      shieldedTicks += world.player.playerShieldIsActive ? 1 : 0;
+      speedSum += world.player.currentSpeed;
+      ticks++;
+    }
+    double simulateMs = simulateTimer.ElapsedMs();
+
+    float elapsed = world.GetStats().elapsed;
+    float blastsPerSecond =
+        world.GetStats().activations[(int)NodeType::ACTION_FIRE] /
+        elapsed;
+    struct Figure {
+      const char *name;
+      float predicted;
+      float measured;
+      bool absolute;
+    } figures[] = {
+        {"blast dps", estimate.actionDps,
+         blastsPerSecond * estimate.blastDamage, false},
+        {"shield uptime", estimate.shieldUptime,
+         (float)shieldedTicks / ticks, true},
+        {"avg speed", estimate.averageSpeed, (float)(speedSum / ticks),
+         false},
+    };
+    for (const Figure &figure : figures) {
+      bool match = Close(figure.predicted, figure.measured, figure.absolute);
+      allMatch = allMatch && match;
+      printf("  %-12s %-14s %10.3f %10.3f%s\n", analyzerCase.name,
+             figure.name, figure.predicted, figure.measured,
+             match ? "" : "   MISMATCH");
+    }
+    printf("  %-12s %-14s %8.2fus %8.1fms\n", analyzerCase.name, "time",
+           analyzeUs, simulateMs);
+  }
+  return allMatch ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <chrono>
+
+// Benchmark cases, dispatched by name from bench/main.cpp.
+// Each case parses its own arguments and prints a plain-text report.
+int RunCircleBench(int argc, char **argv);
+int RunJobBench(int argc, char **argv);
+int RunAnalyzerBench(int argc, char **argv);
+int RunParticleBench(int argc, char **argv);
+int RunAllocBench(int argc, char **argv);
+int RunReplayBench(int argc, char **argv);
+int RunRecordBench(int argc, char **argv);
+
+// Wall-clock stopwatch for the benchmark loops
+class BenchTimer {
+public:
+  BenchTimer() : start(std::chrono::steady_clock::now()) {}
+
+  double ElapsedMs() const {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point start;
+};
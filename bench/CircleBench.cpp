@@ -0,0 +1,82 @@
+#include "Bench.h"
+#include "CircleBatch.h"
+#include "raylib.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const int BENCH_WIDTH = 1600;
+const int BENCH_HEIGHT = 1200;
+const float BULLET_RADIUS = 5.0f;
+
+struct BenchBullet {
+  Vector2 position;
+  Color color;
+};
+
+// raylib is built with SUPPORT_CUSTOM_FRAME_CONTROL, so present explicitly
+template <typename DrawFn> void DrawFrame(DrawFn drawFn) {
+  BeginDrawing();
+  ClearBackground(BLACK);
+  drawFn();
+  EndDrawing();
+  SwapScreenBuffer();
+  PollInputEvents();
+}
+
+// Average frame time in ms over `frames` frames, draw submission plus present
+template <typename DrawFn> double TimeFrames(int frames, DrawFn drawFn) {
+  // Warm up so texture uploads and driver state don't land in the sample
+  for (int i = 0; i < 10; i++)
+    DrawFrame(drawFn);
+
+  BenchTimer timer;
+  for (int i = 0; i < frames; i++)
+    DrawFrame(drawFn);
+  return timer.ElapsedMs() / frames;
+}
+
+} // namespace
+
+int RunCircleBench(int argc, char **argv) {
+  int count = argc > 0 ? atoi(argv[0]) : 10000;
+  int frames = argc > 1 ? atoi(argv[1]) : 200;
+
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  SetTraceLogLevel(LOG_WARNING);
+  InitWindow(BENCH_WIDTH, BENCH_HEIGHT, "rrl_bench - circles");
+  SetTargetFPS(0);
+
+  std::vector<BenchBullet> bullets(count);
+  for (BenchBullet &bullet : bullets) {
+    bullet.position = {(float)GetRandomValue(0, BENCH_WIDTH),
+                       (float)GetRandomValue(0, BENCH_HEIGHT)};
+    bullet.color = GetRandomValue(0, 1) ? YELLOW : ORANGE;
+  }
+
+  CircleBatch circleBatch;
+  circleBatch.Init();
+
+  double fanMs = TimeFrames(frames, [&]() {
+    for (const BenchBullet &bullet : bullets)
+      DrawCircleV(bullet.position, BULLET_RADIUS, bullet.color);
+  });
+
+  double batchMs = TimeFrames(frames, [&]() {
+    circleBatch.Begin();
+    for (const BenchBullet &bullet : bullets)
+      circleBatch.Add(bullet.position, BULLET_RADIUS, bullet.color);
+    circleBatch.End();
+  });
+
+  circleBatch.Unload();
+  CloseWindow();
+
+  printf("circles: %d, frames: %d\n", count, frames);
+  printf("  DrawCircleV   %8.3f ms/frame\n", fanMs);
+  printf("  CircleBatch   %8.3f ms/frame\n", batchMs);
+  printf("  speedup       %8.2fx\n", batchMs > 0.0 ? fanMs / batchMs : 0.0);
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include "Bench.h"
+#include "GameWorld.h"
+#include "JobSystem.h"
+#include "raylib.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int BENCH_WIDTH = 1600;
+const int BENCH_HEIGHT = 1200;
+
+// Deterministic layout so every worker count starts from the same world
+struct BenchLayout {
+  EnemyStore enemies;
+  BulletStore bullets;
+};
+
+void MakeLayout(BenchLayout &layout, int enemyCount, int bulletCount) {
+  uint32_t seed = 12345;
+  auto next = [&seed](int range) {
+    seed = seed * 1664525u + 1013904223u;
+    return (int)((seed >> 8) % (uint32_t)range);
+  };
+
+  // Enemies stay in the top four fifths, well away from the player
+  layout.enemies.Resize(enemyCount);
+  for (int i = 0; i < enemyCount; i++) {
+    layout.enemies.SetAlive(i, true);
+    EnemyBody &body = layout.enemies.Get<EnemyBody>(i);
+    body.position = {(float)next(BENCH_WIDTH),
+                     (float)next(BENCH_HEIGHT * 4 / 5)};
+    body.health = 10 + next(40);
+    body.speed = 100.0f;
+    layout.enemies.Get<EnemyGun>(i) = {2.0f, 0.0f, 0, 0.0f};
+  }
+
+  layout.bullets.Resize(bulletCount);
+  for (int i = 0; i < bulletCount; i++) {
+    layout.bullets.SetAlive(i, true);
+    Motion &motion = layout.bullets.Get<Motion>(i);
+    motion.position = {(float)next(BENCH_WIDTH), (float)next(BENCH_HEIGHT)};
+    motion.velocity = {(float)(next(801) - 400), (float)(next(801) - 400)};
+    layout.bullets.Get<Projectile>(i) = {YELLOW, 5, true};
+  }
+}
+
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  return hash;
+}
+
+uint64_t HashWorld(uint64_t hash, const GameWorld &world) {
+  for (int i = 0; i < world.enemies.GetCapacity(); i++) {
+    const EnemyBody &body = world.enemies.Get<EnemyBody>(i);
+    bool alive = world.enemies.IsAlive(i);
+    hash = HashBytes(hash, &body.position, sizeof(body.position));
+    hash = HashBytes(hash, &body.health, sizeof(body.health));
+    hash = HashBytes(hash, &alive, sizeof(alive));
+  }
+  for (int i = 0; i < world.bullets.GetCapacity(); i++) {
+    const Motion &motion = world.bullets.Get<Motion>(i);
+    bool alive = world.bullets.IsAlive(i);
+    hash = HashBytes(hash, &motion.position, sizeof(motion.position));
+    hash = HashBytes(hash, &alive, sizeof(alive));
+  }
+  for (const InventoryStack &stack : world.player.inventoryStacks)
+    hash = HashBytes(hash, &stack, sizeof(stack));
+  return hash;
+}
+
+struct RunResult {
+  double msPerTick;
+  uint64_t hash;
+};
+
+// Restores the layout before every tick so the load stays constant, and
+// only the tick itself is timed
+RunResult RunTicks(const BenchLayout &layout, JobSystem *jobs, int ticks) {
+  GameWorld world(BENCH_WIDTH, BENCH_HEIGHT, layout.enemies.GetCapacity(),
+                  layout.bullets.GetCapacity());
+  world.Seed(1234);
+  world.Init();
+  world.state = GameState::GAMEPLAY;
+  world.player.position = {BENCH_WIDTH / 2.0f, BENCH_HEIGHT - 30.0f};
+  world.SetJobSystem(jobs);
+
+  PlayerInput input = {};
+  input.aimPosition = {BENCH_WIDTH / 2.0f, 0.0f};
+
+  RunResult result = {0.0, 14695981039346656037ull};
+  double totalMs = 0.0;
+  for (int tick = 0; tick < ticks; tick++) {
+    world.SetEnemies(layout.enemies);
+    world.bullets.CopyFrom(layout.bullets);
+    world.player.currentHealth = world.player.maxHealth;
+
+    BenchTimer timer;
+    world.Tick(input, 1.0f / 60.0f);
+    totalMs += timer.ElapsedMs();
+    result.hash = HashWorld(result.hash, world);
+  }
+  result.msPerTick = totalMs / ticks;
+  return result;
+}
+
+} // namespace
+
+int RunJobBench(int argc, char **argv) {
+  int enemyCount = argc > 0 ? atoi(argv[0]) : 1000;
+  int bulletCount = argc > 1 ? atoi(argv[1]) : 10000;
+  int ticks = argc > 2 ? atoi(argv[2]) : 100;
+  int maxWorkers = argc > 3 ? atoi(argv[3])
+                            : (int)std::thread::hardware_concurrency();
+  if (enemyCount <= 0 || bulletCount <= 0 || ticks <= 0 || maxWorkers <= 0) {
+    fprintf(stderr, "jobs: counts must be positive\n");
+    return 1;
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  BenchLayout layout;
+  MakeLayout(layout, enemyCount, bulletCount);
+
+  // Inline reference: no job system at all
+  RunResult reference = RunTicks(layout, nullptr, ticks);
+
+  printf("enemies: %d, bullets: %d, ticks: %d\n", enemyCount, bulletCount,
+         ticks);
+  printf("  workers   ms/tick   speedup   result\n");
+  printf("  inline   %8.3f   %6.2fx   reference\n", reference.msPerTick, 1.0);
+
+  bool allMatch = true;
+  JobSystem jobs(1);
+  for (int workers = 1; workers <= maxWorkers; workers++) {
+    jobs.SetWorkerCount(workers);
+    RunResult result = RunTicks(layout, &jobs, ticks);
+    bool match = result.hash == reference.hash;
+    allMatch = allMatch && match;
+    printf("  %7d   %8.3f   %6.2fx   %s\n", workers, result.msPerTick,
+           result.msPerTick > 0.0 ? reference.msPerTick / result.msPerTick
+                                  : 0.0,
+           match ? "identical" : "MISMATCH");
+  }
+  return allMatch ? 0 : 1;
+}
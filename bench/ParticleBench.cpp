@@ -0,0 +1,103 @@
+#include "Bench.h"
+#include "CircleBatch.h"
+#include "ParticleSystem.h"
+#include "raylib.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+const int BENCH_WIDTH = 1600;
+const int BENCH_HEIGHT = 1200;
+const float BENCH_DT = 1.0f / 60.0f;
+const int BURST_SIZE = 50;
+const float BURST_LIFETIME = 1.0f;
+
+struct UpdateResult {
+  double msPerFrame;
+  int liveCount;
+  long long dropped;
+};
+
+// Feeds load times the particles a full budget can keep alive, in bursts
+// spread over the arena, and times the updates only
+UpdateResult TimeUpdates(ParticleSystem &particles, float load, int frames) {
+  // Particles live 80% of the burst lifetime on average
+  int perFrame = (int)(load * particles.GetBudget() * BENCH_DT /
+                       (BURST_LIFETIME * 0.8f));
+  uint32_t seed = 12345;
+  auto next = [&seed](int range) {
+    seed = seed * 1664525u + 1013904223u;
+    return (int)((seed >> 8) % (uint32_t)range);
+  };
+  auto emitFrame = [&]() {
+    for (int emitted = 0; emitted < perFrame; emitted += BURST_SIZE)
+      particles.Emit({{(float)next(BENCH_WIDTH), (float)next(BENCH_HEIGHT)},
+                      ORANGE, BURST_SIZE, 300.0f, BURST_LIFETIME, 3.0f,
+                      false});
+  };
+
+  // Warm up until the live count has settled
+  particles.Clear();
+  for (int i = 0; i < 120; i++) {
+    emitFrame();
+    particles.Update(BENCH_DT);
+  }
+
+  double totalMs = 0.0;
+  for (int i = 0; i < frames; i++) {
+    emitFrame();
+    BenchTimer timer;
+    particles.Update(BENCH_DT);
+    totalMs += timer.ElapsedMs();
+  }
+  return {totalMs / frames, particles.GetLiveCount(),
+          particles.GetDroppedCount()};
+}
+
+} // namespace
+
+int RunParticleBench(int argc, char **argv) {
+  int budget = argc > 0 ? atoi(argv[0]) : MAX_PARTICLES;
+  int frames = argc > 1 ? atoi(argv[1]) : 600;
+  if (budget <= 0 || frames <= 0) {
+    fprintf(stderr, "particles: budget and frames must be positive\n");
+    return 1;
+  }
+
+  ParticleSystem particles(budget);
+  printf("particles: budget %d, frames: %d\n", budget, frames);
+  printf("  load   update ms   live      dropped\n");
+  const float loads[] = {0.5f, 1.0f, 2.0f};
+  for (float load : loads) {
+    UpdateResult result = TimeUpdates(particles, load, frames);
+    printf("  %3.1fx   %8.3f   %6d   %10lld\n", load, result.msPerFrame,
+           result.liveCount, result.dropped);
+  }
+
+  // Drawing a full budget, submission plus present
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  SetTraceLogLevel(LOG_WARNING);
+  InitWindow(BENCH_WIDTH, BENCH_HEIGHT, "rrl_bench - particles");
+  SetTargetFPS(0);
+  CircleBatch circleBatch;
+  circleBatch.Init();
+
+  BenchTimer timer;
+  for (int i = 0; i < frames; i++) {
+    BeginDrawing();
+    ClearBackground(BLACK);
+    particles.Draw(circleBatch);
+    EndDrawing();
+    SwapScreenBuffer();
+    PollInputEvents();
+  }
+  double drawMs = timer.ElapsedMs() / frames;
+
+  circleBatch.Unload();
+  CloseWindow();
+  printf("  draw %d particles   %8.3f ms/frame\n", particles.GetLiveCount(),
+         drawMs);
+  return 0;
+}
@@ -0,0 +1,228 @@
+#include "Bench.h"
+#include "BotPolicy.h"
+#include "BuildSpec.h"
+#include "FrameHistogram.h"
+#include "JobSystem.h"
+#include "ReplayLog.h"
+#include "raylib.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ReplayResult {
+  std::string path;
+  bool loaded;
+  int ticks; // Ticks played before the run ended
+  uint64_t hash;
+  uint64_t expectedHash; // 0 when the log has none
+  uint64_t p50Us;
+  uint64_t p99Us;
+  uint64_t maxUs;
+  double budgetUs; // 0 when the log has none
+
+  bool HashMatches() const { return expectedHash == 0 || hash == expectedHash; }
+  bool WithinBudget() const { return budgetUs <= 0.0 || p99Us <= budgetUs; }
+  // One check or the other, so a slow machine never reads as a desync
+  bool Passed(bool checkBudgets) const {
+    return loaded && (checkBudgets ? WithinBudget() : HashMatches());
+  }
+};
+
+ReplayResult Replay(const std::string &path, JobSystem &jobs) {
+  ReplayResult result = {};
+  result.path = path;
+  ReplayLog log;
+  if (!LoadReplayLog(path, log))
+    return result;
+
+  GameWorld world(log.width, log.height, log.enemies);
+  world.SetJobSystem(&jobs);
+  if (!PrepareReplayWorld(log, GetDirectoryPath(path.c_str()), world))
+    return result;
+  result.loaded = true;
+  result.expectedHash = log.finalHash;
+  result.budgetUs = log.budgetUs;
+
+  // Ticks after the run has ended do nothing, so they aren't timed
+  FrameHistogram tickTimes("tick");
+  float dt = 1.0f / log.tickRate;
+  for (const PlayerInput &input : log.inputs) {
+    if (world.state != GameState::GAMEPLAY)
+      break;
+    BenchTimer timer;
+    world.Tick(input, dt);
+    tickTimes.Record((uint64_t)(timer.ElapsedMs() * 1000.0 + 0.5));
+    result.ticks++;
+  }
+  result.hash = HashWorldState(world);
+  result.p50Us = tickTimes.GetPercentile(50.0);
+  result.p99Us = tickTimes.GetPercentile(99.0);
+  result.maxUs = tickTimes.GetMax();
+  return result;
+}
+
+void WriteJsonString(FILE *file, const std::string &text) {
+  fputc('"', file);
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      fputc('\\', file);
+    fputc(c, file);
+  }
+  fputc('"', file);
+}
+
+bool WriteJson(const char *path, const std::vector<ReplayResult> &results,
+               bool checkBudgets) {
+  FILE *file = fopen(path, "w");
+  if (!file)
+    return false;
+  fprintf(file, "{\"check\":\"%s\",\"replays\":[",
+          checkBudgets ? "budgets" : "hashes");
+  for (size_t i = 0; i < results.size(); i++) {
+    const ReplayResult &result = results[i];
+    fprintf(file, "%s\n {\"log\":", i > 0 ? "," : "");
+    WriteJsonString(file, result.path);
+    fprintf(file,
+            ",\"loaded\":%s,\"ticks\":%d,\"hash\":\"%016llx\","
+            "\"expectedHash\":\"%016llx\",\"hashMatch\":%s,"
+            "\"p50Us\":%llu,\"p99Us\":%llu,\"maxUs\":%llu,"
+            "\"budgetP99Us\":%g,\"withinBudget\":%s,\"passed\":%s}",
+            result.loaded ? "true" : "false", result.ticks,
+            (unsigned long long)result.hash,
+            (unsigned long long)result.expectedHash,
+            result.HashMatches() ? "true" : "false",
+            (unsigned long long)result.p50Us,
+            (unsigned long long)result.p99Us,
+            (unsigned long long)result.maxUs, result.budgetUs,
+            result.WithinBudget() ? "true" : "false",
+            result.Passed(checkBudgets) ? "true" : "false");
+  }
+  fprintf(file, "\n]}\n");
+  bool written = !ferror(file);
+  fclose(file);
+  return written;
+}
+
+} // namespace
+
+// Replays input logs (every .log in assets/replays by default) and checks
+// each run's final state hash against the log, or with --budgets its p99
+// tick time instead. Exits non-zero if any check fails, so it can gate a
+// CI step.
+int RunReplayBench(int argc, char **argv) {
+  const char *jsonPath = "rrl_replay.json";
+  bool checkBudgets = false;
+  std::vector<std::string> paths;
+  for (int i = 0; i < argc; i++) {
+    if (strncmp(argv[i], "--json=", 7) == 0)
+      jsonPath = argv[i] + 7;
+    else if (strcmp(argv[i], "--budgets") == 0)
+      checkBudgets = true;
+    else
+      paths.push_back(argv[i]);
+  }
+  SetTraceLogLevel(LOG_WARNING);
+  if (paths.empty()) {
+    FilePathList files =
+        LoadDirectoryFilesEx(ASSETS_PATH "replays", ".log", false);
+    for (unsigned int i = 0; i < files.count; i++)
+      paths.push_back(files.paths[i]);
+    UnloadDirectoryFiles(files);
+  }
+  if (paths.empty()) {
+    fprintf(stderr, "replay: no logs given or found\n");
+    return 1;
+  }
+
+  JobSystem jobs(0);
+  printf("replay: %zu logs on %d threads, checking %s\n", paths.size(),
+         jobs.GetWorkerCount(), checkBudgets ? "p99 budgets" : "hashes");
+  printf("  %-28s %6s %-6s %8s %8s %8s %8s\n", "log", "ticks", "hash",
+         "p50 us", "p99 us", "max us", "budget");
+  std::vector<ReplayResult> results;
+  bool passed = true;
+  for (const std::string &path : paths) {
+    ReplayResult result = Replay(path, jobs);
+    results.push_back(result);
+    passed = passed && result.Passed(checkBudgets);
+    if (!result.loaded) {
+      printf("  %-28s could not be loaded\n", GetFileName(path.c_str()));
+      continue;
+    }
+    printf("  %-28s %6d %-6s %8llu %8llu %8llu %8.0f%s\n",
+           GetFileName(path.c_str()), result.ticks,
+           result.expectedHash == 0 ? "none"
+           : result.HashMatches()   ? "ok"
+                                    : "DIFF",
+           (unsigned long long)result.p50Us, (unsigned long long)result.p99Us,
+           (unsigned long long)result.maxUs, result.budgetUs,
+           result.WithinBudget() ? "" : "  OVER BUDGET");
+  }
+
+  if (!WriteJson(jsonPath, results, checkBudgets)) {
+    fprintf(stderr, "replay: could not write %s\n", jsonPath);
+    return 1;
+  }
+  printf("%s, results in %s\n", passed ? "passed" : "FAILED", jsonPath);
+  return passed ? 0 : 1;
+}
+
+// Records a log from a bot playing a build: its policy, or kite without
+// one. The build path is relative to the log, as stored in it. A positive
+// enemy count keeps that many on the field with the endless wave.
+int RunRecordBench(int argc, char **argv) {
+  if (argc < 1) {
+    fprintf(stderr, "record: needs an output path\n");
+    return 1;
+  }
+  std::string outPath = argv[0];
+  ReplayLog log;
+  if (argc > 1 && strcmp(argv[1], "-") != 0)
+    log.buildPath = argv[1];
+  float seconds = argc > 2 ? (float)atof(argv[2]) : 30.0f;
+  int enemies = argc > 3 ? atoi(argv[3]) : 0;
+  log.budgetUs = argc > 4 ? atof(argv[4]) : 0.0;
+  if (seconds <= 0.0f || enemies < 0 || log.budgetUs < 0.0) {
+    fprintf(stderr, "record: invalid duration, enemy count or budget\n");
+    return 1;
+  }
+  if (enemies > 0) {
+    log.enemies = enemies;
+    log.endless = true;
+  }
+  SetTraceLogLevel(LOG_WARNING);
+
+  std::string logDir = GetDirectoryPath(outPath.c_str());
+  BotPolicy policy = BotPolicy::KITE;
+  if (!log.buildPath.empty()) {
+    BuildSpec spec;
+    if (!LoadBuildSpec(logDir + "/" + log.buildPath, spec))
+      return 1;
+    policy = spec.policy;
+  }
+
+  GameWorld world(log.width, log.height, log.enemies);
+  if (!PrepareReplayWorld(log, logDir, world))
+    return 1;
+  float dt = 1.0f / log.tickRate;
+  int ticks = (int)(seconds * log.tickRate);
+  for (int i = 0; i < ticks && world.state == GameState::GAMEPLAY; i++) {
+    PlayerInput input = QuantizeInput(DecideBotInput(policy, world));
+    world.Tick(input, dt);
+    log.inputs.push_back(input);
+  }
+  log.finalHash = HashWorldState(world);
+
+  if (!SaveReplayLog(outPath, log)) {
+    fprintf(stderr, "record: could not write %s\n", outPath.c_str());
+    return 1;
+  }
+  printf("record: %zu ticks (%s), hash %016llx -> %s\n", log.inputs.size(),
+         world.state == GameState::GAMEPLAY ? "survived" : "died",
+         (unsigned long long)log.finalHash, outPath.c_str());
+  return 0;
+}
@@ -0,0 +1,52 @@
+// bench/main.cpp - Entry point for the rrl_bench target
+#include "Bench.h"
+#include <cstdio>
+#include <cstring>
+
+struct BenchCase {
+  const char *name;
+  const char *description;
+  int (*run)(int argc, char **argv);
+};
+
+static const BenchCase benchCases[] = {
+    {"circles", "DrawCircleV vs CircleBatch [count] [frames]",
+     RunCircleBench},
+    {"jobs", "enemy/bullet tick scaling [enemies] [bullets] [ticks] [workers]",
+     RunJobBench},
+    {"analyzer", "BuildAnalyzer vs headless simulation [seconds]",
+     RunAnalyzerBench},
+    {"particles", "particle update under load and full-budget draw "
+                  "[budget] [frames]",
+     RunParticleBench},
+    {"allocs", "heap allocations per steady-state tick "
+               "[build] [seconds] [max per tick]",
+     RunAllocBench},
+    {"replay", "replay input logs and check their state hashes, or their "
+               "p99 tick budgets [--budgets] [--json=PATH] [log...]",
+     RunReplayBench},
+    {"record", "record a bot session as an input log "
+               "OUT [build|-] [seconds] [enemies] [budget us]",
+     RunRecordBench},
+};
+
+static void PrintUsage(const char *program) {
+  printf("usage: %s <case> [args...]\n\ncases:\n", program);
+  for (const BenchCase &benchCase : benchCases)
+    printf("  %-10s %s\n", benchCase.name, benchCase.description);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  for (const BenchCase &benchCase : benchCases) {
+    if (strcmp(argv[1], benchCase.name) == 0)
+      return benchCase.run(argc - 2, argv + 2);
+  }
+
+  PrintUsage(argv[0]);
+  return 1;
+}
@@ -0,0 +1,53 @@
+#include "ActionScheduler.h"
+#include <algorithm>
+
+ActionScheduler::ActionScheduler() : clock(0.0), nextOrder(0), nextHandle(0) {}
+
+bool ActionScheduler::Later(const Entry &a, const Entry &b) {
+  if (a.due != b.due)
+    return a.due > b.due;
+  return a.order > b.order;
+}
+
+void ActionScheduler::Push(Entry entry) {
+  entry.order = nextOrder++;
+  heap.push_back(entry);
+  std::push_heap(heap.begin(), heap.end(), Later);
+}
+
+ActionScheduler::Handle ActionScheduler::Schedule(const ActionTask &task,
+                                                  float seconds) {
+  Handle handle = nextHandle++;
+  Push({clock + seconds, 0, handle, task});
+  return handle;
+}
+
+void ActionScheduler::Cancel(Handle handle) {
+  // Dropped lazily when the entry reaches the top
+  for (const Entry &entry : heap) {
+    if (entry.handle == handle) {
+      cancelled.push_back(handle);
+      return;
+    }
+  }
+}
+
+void ActionScheduler::Clear() {
+  heap.clear();
+  cancelled.clear();
+}
+
+bool ActionScheduler::PopDue(double dueBy, Entry &entry) {
+  while (!heap.empty() && heap.front().due <= dueBy) {
+    std::pop_heap(heap.begin(), heap.end(), Later);
+    entry = heap.back();
+    heap.pop_back();
+
+    auto wasCancelled =
+        std::find(cancelled.begin(), cancelled.end(), entry.handle);
+    if (wasCancelled == cancelled.end())
+      return true;
+    cancelled.erase(wasCancelled);
+  }
+  return false;
+}
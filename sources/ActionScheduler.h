@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+
+// Due times are sums of float tick lengths, so compare with some slack
+const double ACTION_CLOCK_EPSILON = 1e-6;
+
+// An action written as an explicit stackless state machine: each resume
+// runs from `phase` to the next wait and records where to carry on. Loop
+// state for multi-phase actions (shots left in a burst, say) goes in
+// `counter`, so nothing lives on a stack between resumes.
+struct ActionTask {
+  int nodeId;
+  int phase;   // Resume point, 0 on the first run
+  int counter; // Free for the action's own loops
+};
+
+// What a task asks for when it yields
+struct ActionWait {
+  bool done;
+  float seconds;
+
+  static ActionWait For(float seconds) { return {false, seconds}; }
+  static ActionWait Done() { return {true, 0.0f}; }
+};
+
+// Parks tasks until their wait is over and resumes only those, so a
+// waiting action costs nothing per tick. The clock is the sum of the tick
+// lengths. A task that waits s seconds during a tick resumes on the first
+// later tick that starts at least s after that tick ended.
+class ActionScheduler {
+public:
+  typedef int Handle;
+
+  ActionScheduler();
+
+  // Parks task for seconds from the end of the current tick
+  Handle Schedule(const ActionTask &task, float seconds);
+  void Cancel(Handle handle);
+  void Clear();
+
+  // Moves the clock to the end of a tick of length dt and resumes every
+  // task due by its start, earliest first, by calling resume(ActionTask &)
+  // for an ActionWait. Tasks may schedule new ones. A template so the call
+  // inlines and ticks don't build a std::function on the heap.
+  template <typename Resume> void Advance(float dt, Resume &&resume);
+
+  double GetClock() const { return clock; }
+  bool IsIdle() const { return heap.empty(); }
+
+private:
+  struct Entry {
+    double due;
+    unsigned long long order; // Keeps equal due times first-in first-out
+    Handle handle;
+    ActionTask task;
+  };
+
+  std::vector<Entry> heap; // Min-heap on (due, order)
+  std::vector<Handle> cancelled;
+  double clock;
+  unsigned long long nextOrder;
+  Handle nextHandle;
+
+  static bool Later(const Entry &a, const Entry &b);
+  void Push(Entry entry);
+  // Pops the next entry due by dueBy into entry, skipping cancelled ones
+  bool PopDue(double dueBy, Entry &entry);
+};
+
+template <typename Resume>
+void ActionScheduler::Advance(float dt, Resume &&resume) {
+  double tickStart = clock;
+  clock += dt;
+
+  Entry entry;
+  while (PopDue(tickStart + ACTION_CLOCK_EPSILON, entry)) {
+    ActionWait wait = resume(entry.task);
+    if (!wait.done) {
+      entry.due = clock + wait.seconds;
+      Push(entry);
+    }
+  }
+}
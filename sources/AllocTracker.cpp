@@ -0,0 +1,359 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define ALLOC_BACKTRACE 1
+#endif
+
+#if defined(__GNUC__)
+#define ALLOC_NOINLINE __attribute__((noinline))
+#define ALLOC_INLINE inline __attribute__((always_inline))
+#else
+#define ALLOC_NOINLINE
+#define ALLOC_INLINE inline
+#endif
+
+namespace {
+
+struct LiveCounts {
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> frees;
+
+  AllocCounts Take() {
+    return {allocations.exchange(0, std::memory_order_relaxed),
+            bytes.exchange(0, std::memory_order_relaxed),
+            frees.exchange(0, std::memory_order_relaxed)};
+  }
+};
+
+LiveCounts totals;
+LiveCounts zoneCounts[AllocTracker::MAX_ZONES];
+thread_local uint32_t openZones = 0;
+
+// Sampled callstacks, open-addressed by a hash of their frames. Samples
+// that find the table full are dropped.
+const int SITE_SLOTS = 1024;
+std::atomic<int> sampleInterval{0};
+std::atomic<uint64_t> sampleCounter{0};
+std::mutex siteMutex;
+AllocTracker::Site sites[SITE_SLOTS];
+
+#ifdef RRL_ALLOC_TRACKING
+#ifdef ALLOC_BACKTRACE
+// The sampler, RecordAllocation and operator new itself
+const int SKIPPED_FRAMES = 3;
+// backtrace() may allocate the first time it runs
+thread_local bool capturing = false;
+
+ALLOC_NOINLINE void SampleSite(size_t bytes) {
+  const int capacity = SKIPPED_FRAMES + AllocTracker::MAX_SITE_FRAMES;
+  void *frames[capacity];
+  capturing = true;
+  int depth = backtrace(frames, capacity);
+  capturing = false;
+  depth -= SKIPPED_FRAMES;
+  if (depth <= 0)
+    return;
+  void **stack = frames + SKIPPED_FRAMES;
+
+  uint64_t hash = 14695981039346656037ull;
+  for (int i = 0; i < depth; i++)
+    hash = (hash ^ (uint64_t)(uintptr_t)stack[i]) * 1099511628211ull;
+
+  std::lock_guard<std::mutex> lock(siteMutex);
+  for (int probe = 0; probe < SITE_SLOTS; probe++) {
+    AllocTracker::Site &site = sites[(hash + probe) % SITE_SLOTS];
+    if (site.samples == 0) {
+      memcpy(site.frames, stack, depth * sizeof(void *));
+      site.depth = depth;
+    } else if (site.depth != depth ||
+               memcmp(site.frames, stack, depth * sizeof(void *)) != 0) {
+      continue;
+    }
+    site.samples++;
+    site.bytes += bytes;
+    return;
+  }
+}
+#endif
+
+// Samples before counting so the call to the sampler is never a tail call,
+// which keeps SKIPPED_FRAMES right
+ALLOC_NOINLINE void RecordAllocation(size_t bytes) {
+#ifdef ALLOC_BACKTRACE
+  int interval = sampleInterval.load(std::memory_order_relaxed);
+  if (interval > 0 && !capturing &&
+      sampleCounter.fetch_add(1, std::memory_order_relaxed) % interval == 0)
+    SampleSite(bytes);
+#endif
+  totals.allocations.fetch_add(1, std::memory_order_relaxed);
+  totals.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  uint32_t zones = openZones;
+  for (int zone = 0; zones != 0; zone++, zones >>= 1) {
+    if (zones & 1u) {
+      zoneCounts[zone].allocations.fetch_add(1, std::memory_order_relaxed);
+      zoneCounts[zone].bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+}
+
+void RecordFree() {
+  totals.frees.fetch_add(1, std::memory_order_relaxed);
+  uint32_t zones = openZones;
+  for (int zone = 0; zones != 0; zone++, zones >>= 1) {
+    if (zones & 1u)
+      zoneCounts[zone].frees.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ALLOC_INLINE void *TrackedAlloc(size_t size) {
+  RecordAllocation(size);
+  return malloc(size ? size : 1);
+}
+
+ALLOC_INLINE void *TrackedAlignedAlloc(size_t size, std::align_val_t align) {
+  RecordAllocation(size);
+  size_t alignment = (size_t)align;
+#ifdef _WIN32
+  return _aligned_malloc(size ? size : 1, alignment);
+#else
+  // aligned_alloc wants a whole number of alignments
+  size_t rounded = (size + alignment - 1) / alignment * alignment;
+  return aligned_alloc(alignment, rounded ? rounded : alignment);
+#endif
+}
+
+void TrackedFree(void *memory) {
+  if (!memory)
+    return;
+  RecordFree();
+  free(memory);
+}
+
+void TrackedAlignedFree(void *memory) {
+  if (!memory)
+    return;
+  RecordFree();
+#ifdef _WIN32
+  _aligned_free(memory);
+#else
+  free(memory);
+#endif
+}
+#endif
+
+#ifdef ALLOC_BACKTRACE
+// "module(mangled+0x1c) [0x...]" as "Demangled+0x1c", or as it came when
+// the symbol isn't exported
+std::string DescribeFrame(const char *symbol) {
+  std::string text = symbol;
+  size_t open = text.find('(');
+  size_t plus = text.find('+', open);
+  size_t close = text.find(')', plus);
+  if (open == std::string::npos || plus == std::string::npos ||
+      close == std::string::npos || plus == open + 1)
+    return text;
+
+  std::string mangled = text.substr(open + 1, plus - open - 1);
+  int status = 0;
+  char *demangled =
+      abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+  if (status != 0)
+    return text;
+  std::string described = demangled + text.substr(plus, close - plus);
+  free(demangled);
+  return described;
+}
+#endif
+
+} // namespace
+
+bool AllocTracker::IsEnabled() {
+#ifdef RRL_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+AllocCounts AllocTracker::TakeTotals() { return totals.Take(); }
+
+AllocCounts AllocTracker::TakeZone(int zone) {
+  if (zone < 0 || zone >= MAX_ZONES)
+    return {};
+  return zoneCounts[zone].Take();
+}
+
+uint32_t AllocTracker::EnterZone(int zone) {
+  uint32_t previous = openZones;
+  openZones = previous | (1u << zone);
+  return previous;
+}
+
+void AllocTracker::LeaveZone(uint32_t previous) { openZones = previous; }
+
+void AllocTracker::SetSampleInterval(int interval) {
+  sampleInterval.store(interval > 0 ? interval : 0,
+                       std::memory_order_relaxed);
+}
+
+bool AllocTracker::IsSampling() {
+#if defined(RRL_ALLOC_TRACKING) && defined(ALLOC_BACKTRACE)
+  return sampleInterval.load(std::memory_order_relaxed) > 0;
+#else
+  return false;
+#endif
+}
+
+void AllocTracker::ClearSites() {
+  std::lock_guard<std::mutex> lock(siteMutex);
+  memset(sites, 0, sizeof(sites));
+}
+
+int AllocTracker::GetTopSites(Site *top, int maxSites) {
+  if (maxSites <= 0)
+    return 0;
+  // Insertion into a short sorted list, busiest first
+  int count = 0;
+  std::lock_guard<std::mutex> lock(siteMutex);
+  for (const Site &site : sites) {
+    if (site.samples == 0)
+      continue;
+    int at = count;
+    if (count < maxSites) {
+      count++;
+    } else if (site.samples > top[maxSites - 1].samples) {
+      at = maxSites - 1;
+    } else {
+      continue;
+    }
+    while (at > 0 && top[at - 1].samples < site.samples) {
+      top[at] = top[at - 1];
+      at--;
+    }
+    top[at] = site;
+  }
+  return count;
+}
+
+void AllocTracker::PrintTopSites(FILE *out, int maxSites) {
+  std::vector<Site> top(maxSites > 0 ? maxSites : 0);
+  int count = GetTopSites(top.data(), maxSites);
+  if (count == 0) {
+    fprintf(out, "allocation sites: nothing sampled\n");
+    return;
+  }
+  fprintf(out, "top %d allocation sites by samples:\n", count);
+  for (int i = 0; i < count; i++) {
+    const Site &site = top[i];
+    fprintf(out, "  #%d  %llu samples, %llu bytes\n", i + 1,
+            (unsigned long long)site.samples,
+            (unsigned long long)site.bytes);
+#ifdef ALLOC_BACKTRACE
+    char **symbols = backtrace_symbols(site.frames, site.depth);
+    for (int frame = 0; frame < site.depth; frame++)
+      fprintf(out, "      %s\n",
+              symbols ? DescribeFrame(symbols[frame]).c_str() : "?");
+    free(symbols);
+#endif
+  }
+}
+
+#ifdef RRL_ALLOC_TRACKING
+// Replacements for every global form. Failing throwing forms throw
+// without consulting a new_handler, which the game never installs.
+
+void *operator new(size_t size) {
+  void *memory = TrackedAlloc(size);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new[](size_t size) {
+  void *memory = TrackedAlloc(size);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return TrackedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return TrackedAlloc(size);
+}
+
+void *operator new(size_t size, std::align_val_t align) {
+  void *memory = TrackedAlignedAlloc(size, align);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new[](size_t size, std::align_val_t align) {
+  void *memory = TrackedAlignedAlloc(size, align);
+  if (!memory)
+    throw std::bad_alloc();
+  return memory;
+}
+
+void *operator new(size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return TrackedAlignedAlloc(size, align);
+}
+
+void *operator new[](size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return TrackedAlignedAlloc(size, align);
+}
+
+void operator delete(void *memory) noexcept { TrackedFree(memory); }
+void operator delete[](void *memory) noexcept { TrackedFree(memory); }
+void operator delete(void *memory, size_t) noexcept { TrackedFree(memory); }
+void operator delete[](void *memory, size_t) noexcept { TrackedFree(memory); }
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept {
+  TrackedFree(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept {
+  TrackedFree(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+  TrackedAlignedFree(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept {
+  TrackedAlignedFree(memory);
+}
+
+void operator delete(void *memory, size_t, std::align_val_t) noexcept {
+  TrackedAlignedFree(memory);
+}
+
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept {
+  TrackedAlignedFree(memory);
+}
+
+void operator delete(void *memory, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  TrackedAlignedFree(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  TrackedAlignedFree(memory);
+}
+#endif
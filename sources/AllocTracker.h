@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// Heap allocation counts from replacements of the global operator new and
+// delete, compiled in by the RRL_ALLOC_TRACKING CMake option. It is off by
+// default since the hooks add a few atomics to every allocation; without it
+// every count stays zero and IsEnabled returns false.
+//
+// Totals cover every thread. Zone counts cover allocations made on a
+// thread while it is inside the zone (see ProfileScope), so work a zone
+// hands to job system workers only shows in the totals.
+struct AllocCounts {
+  uint64_t allocations;
+  uint64_t bytes; // As requested
+  uint64_t frees;
+};
+
+class AllocTracker {
+public:
+  static const int MAX_ZONES = 32;
+  static const int MAX_SITE_FRAMES = 8;
+
+  // A distinct callstack among the sampled allocations
+  struct Site {
+    void *frames[MAX_SITE_FRAMES]; // Innermost first
+    int depth;
+    uint64_t samples;
+    uint64_t bytes; // Summed over the samples
+  };
+
+  static bool IsEnabled();
+
+  // Counts since the previous Take, then starts over
+  static AllocCounts TakeTotals();
+  static AllocCounts TakeZone(int zone);
+
+  // The calling thread's open zones are a bit set. Enter returns the set
+  // before the zone was added, for Leave to restore.
+  static uint32_t EnterZone(int zone);
+  static void LeaveZone(uint32_t previous);
+
+  // Records the callstack of one in every `interval` allocations, 0 to
+  // stop. Needs backtrace() (glibc or macOS); elsewhere nothing is sampled.
+  static void SetSampleInterval(int interval);
+  static bool IsSampling();
+  static void ClearSites();
+  // Busiest sites by sample count; returns how many were filled in
+  static int GetTopSites(Site *sites, int maxSites);
+  // Top sites with a symbol per frame
+  static void PrintTopSites(FILE *out, int maxSites);
+};
@@ -0,0 +1,456 @@
+#include "AtlasBuilder.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+const uint32_t ATLAS_MAGIC = 0x414C5252; // "RRLA"
+const uint32_t ATLAS_VERSION = 1;
+
+// FNV-1a, used to fingerprint the atlas sources
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t HashFile(uint64_t hash, const std::string &path) {
+  long modTime = GetFileModTime(path.c_str());
+  hash = HashBytes(hash, path.data(), path.size());
+  return HashBytes(hash, &modTime, sizeof(modTime));
+}
+
+// Bottom-left skyline packer. Each node is a horizontal segment of the
+// current top edge; rectangles are placed where they end up lowest.
+class SkylinePacker {
+public:
+  SkylinePacker(int width, int height) : width(width), height(height) {
+    skyline.push_back({0, 0, width});
+  }
+
+  bool Insert(int w, int h, int &outX, int &outY) {
+    int bestIndex = -1;
+    int bestBottom = height + 1;
+    int bestWidth = width + 1;
+    for (size_t i = 0; i < skyline.size(); i++) {
+      int y;
+      if (!Fits(i, w, h, y))
+        continue;
+      if (y + h < bestBottom ||
+          (y + h == bestBottom && skyline[i].width < bestWidth)) {
+        bestIndex = (int)i;
+        bestBottom = y + h;
+        bestWidth = skyline[i].width;
+        outX = skyline[i].x;
+        outY = y;
+      }
+    }
+    if (bestIndex == -1)
+      return false;
+
+    // Raise the skyline under the new rectangle
+    skyline.insert(skyline.begin() + bestIndex, {outX, outY + h, w});
+    for (size_t i = bestIndex + 1; i < skyline.size();) {
+      int shrink = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+      if (shrink <= 0)
+        break;
+      skyline[i].x += shrink;
+      skyline[i].width -= shrink;
+      if (skyline[i].width <= 0)
+        skyline.erase(skyline.begin() + i);
+      else
+        break;
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size();) {
+      if (skyline[i].y == skyline[i + 1].y) {
+        skyline[i].width += skyline[i + 1].width;
+        skyline.erase(skyline.begin() + i + 1);
+      } else {
+        i++;
+      }
+    }
+    return true;
+  }
+
+private:
+  struct Node {
+    int x, y, width;
+  };
+
+  int width;
+  int height;
+  std::vector<Node> skyline;
+
+  bool Fits(size_t index, int w, int h, int &outY) const {
+    if (skyline[index].x + w > width)
+      return false;
+    int remaining = w;
+    outY = 0;
+    for (size_t i = index; remaining > 0; i++) {
+      if (i >= skyline.size())
+        return false;
+      outY = std::max(outY, skyline[i].y);
+      if (outY + h > height)
+        return false;
+      remaining -= skyline[i].width;
+    }
+    return true;
+  }
+};
+
+template <typename T> void WriteValue(FILE *file, const T &value) {
+  fwrite(&value, sizeof(T), 1, file);
+}
+
+template <typename T> bool ReadValue(FILE *file, T &value) {
+  return fread(&value, sizeof(T), 1, file) == 1;
+}
+
+} // namespace
+
+AtlasBuilder::AtlasBuilder(const std::string &assetsDir, int pageSize,
+                           int padding)
+    : assetsDir(assetsDir), pageSize(pageSize), padding(padding) {}
+
+bool AtlasBuilder::ReadSpecs(std::vector<SpriteSpec> &specs,
+                             uint64_t &sourceStamp) const {
+  specs.clear();
+  sourceStamp = 14695981039346656037ull;
+
+  // Sliced sheets from the manifest
+  std::string manifestPath = assetsDir + "atlas.txt";
+  char *manifest = LoadFileText(manifestPath.c_str());
+  if (manifest) {
+    sourceStamp = HashBytes(sourceStamp, manifest, strlen(manifest));
+
+    std::istringstream lines(manifest);
+    std::string line;
+    std::string sheetPath;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+      lineNumber++;
+      std::istringstream tokens(line);
+      std::string keyword;
+      if (!(tokens >> keyword) || keyword[0] == '#')
+        continue;
+
+      if (keyword == "sheet") {
+        std::string sheet;
+        tokens >> sheet;
+        sheetPath = assetsDir + sheet;
+        sourceStamp = HashFile(sourceStamp, sheetPath);
+      } else if (keyword == "sprite" && !sheetPath.empty()) {
+        SpriteSpec spec = {};
+        spec.imagePath = sheetPath;
+        if (!(tokens >> spec.name >> spec.cell.x >> spec.cell.y >>
+              spec.cell.width >> spec.cell.height)) {
+          TraceLog(LOG_WARNING, "ATLAS: %s:%d: malformed sprite entry",
+                   manifestPath.c_str(), lineNumber);
+          continue;
+        }
+
+        std::string option;
+        while (tokens >> option) {
+          if (option == "collision") {
+            spec.hasCollision = true;
+            tokens >> spec.collision.x >> spec.collision.y >>
+                spec.collision.width >> spec.collision.height;
+          } else if (option == "npatch") {
+            spec.hasNPatch = true;
+            spec.nPatch.layout = NPATCH_NINE_PATCH;
+            tokens >> spec.nPatch.source.x >> spec.nPatch.source.y >>
+                spec.nPatch.source.width >> spec.nPatch.source.height >>
+                spec.nPatch.left >> spec.nPatch.top >> spec.nPatch.right >>
+                spec.nPatch.bottom;
+          }
+        }
+
+        specs.push_back(spec);
+      } else {
+        TraceLog(LOG_WARNING, "ATLAS: %s:%d: unknown entry '%s'",
+                 manifestPath.c_str(), lineNumber, keyword.c_str());
+      }
+    }
+    UnloadFileText(manifest);
+  }
+
+  // Loose sprites, one per file
+  std::string spritesDir = assetsDir + "sprites";
+  if (DirectoryExists(spritesDir.c_str())) {
+    FilePathList files = LoadDirectoryFilesEx(spritesDir.c_str(), ".png", false);
+    std::vector<std::string> paths(files.paths, files.paths + files.count);
+    UnloadDirectoryFiles(files);
+
+    // Directory order is not stable across platforms
+    std::sort(paths.begin(), paths.end());
+    for (const std::string &path : paths) {
+      SpriteSpec spec = {};
+      spec.name = GetFileNameWithoutExt(path.c_str());
+      spec.imagePath = path;
+      specs.push_back(spec);
+      sourceStamp = HashFile(sourceStamp, path);
+    }
+  }
+
+  return !specs.empty();
+}
+
+bool AtlasBuilder::Build(Atlas &atlas) {
+  std::vector<SpriteSpec> specs;
+  uint64_t sourceStamp;
+  if (!ReadSpecs(specs, sourceStamp)) {
+    TraceLog(LOG_WARNING, "ATLAS: No sprites found in %s", assetsDir.c_str());
+    return false;
+  }
+
+  // Decode every source image once
+  std::map<std::string, Image> images;
+  for (const SpriteSpec &spec : specs) {
+    if (images.count(spec.imagePath))
+      continue;
+    Image image = LoadImage(spec.imagePath.c_str());
+    if (image.data)
+      ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    images[spec.imagePath] = image;
+  }
+
+  // Sprites that slice the same cell share one packed copy
+  struct PackItem {
+    std::string imagePath;
+    Rectangle cell;
+    int page;
+    int x, y;
+  };
+  std::vector<PackItem> items;
+  std::vector<int> specItems(specs.size(), -1);
+
+  for (size_t i = 0; i < specs.size(); i++) {
+    const SpriteSpec &spec = specs[i];
+    const Image &image = images[spec.imagePath];
+    if (!image.data)
+      continue;
+
+    Rectangle cell = spec.cell;
+    if (cell.width == 0 || cell.height == 0)
+      cell = {0, 0, (float)image.width, (float)image.height};
+    if (cell.x < 0 || cell.y < 0 || cell.x + cell.width > image.width ||
+        cell.y + cell.height > image.height ||
+        cell.width + padding > pageSize || cell.height + padding > pageSize) {
+      TraceLog(LOG_WARNING, "ATLAS: Sprite '%s' does not fit its image",
+               spec.name.c_str());
+      continue;
+    }
+
+    for (size_t j = 0; j < items.size(); j++) {
+      if (items[j].imagePath == spec.imagePath &&
+          memcmp(&items[j].cell, &cell, sizeof(Rectangle)) == 0) {
+        specItems[i] = (int)j;
+        break;
+      }
+    }
+    if (specItems[i] == -1) {
+      specItems[i] = (int)items.size();
+      items.push_back({spec.imagePath, cell, -1, 0, 0});
+    }
+  }
+
+  // Tallest first keeps the skyline flat
+  std::vector<int> order(items.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    if (items[a].cell.height != items[b].cell.height)
+      return items[a].cell.height > items[b].cell.height;
+    return items[a].cell.width > items[b].cell.width;
+  });
+
+  std::vector<SkylinePacker> packers;
+  for (int index : order) {
+    PackItem &item = items[index];
+    int w = (int)item.cell.width + padding;
+    int h = (int)item.cell.height + padding;
+    for (size_t p = 0; p < packers.size() && item.page == -1; p++) {
+      if (packers[p].Insert(w, h, item.x, item.y))
+        item.page = (int)p;
+    }
+    if (item.page == -1) {
+      packers.emplace_back(pageSize, pageSize);
+      packers.back().Insert(w, h, item.x, item.y);
+      item.page = (int)packers.size() - 1;
+    }
+  }
+
+  // Pages are trimmed to the area actually used
+  atlas.pages.assign(packers.size(), AtlasPage{0, 0, {}});
+  for (const PackItem &item : items) {
+    AtlasPage &page = atlas.pages[item.page];
+    page.width = std::max(page.width, item.x + (int)item.cell.width);
+    page.height = std::max(page.height, item.y + (int)item.cell.height);
+  }
+  for (AtlasPage &page : atlas.pages)
+    page.pixels.assign((size_t)page.width * page.height * 4, 0);
+
+  for (const PackItem &item : items) {
+    AtlasPage &page = atlas.pages[item.page];
+    const Image &image = images[item.imagePath];
+    const unsigned char *src = (const unsigned char *)image.data;
+    int cellX = (int)item.cell.x, cellY = (int)item.cell.y;
+    for (int row = 0; row < (int)item.cell.height; row++) {
+      memcpy(&page.pixels[((size_t)(item.y + row) * page.width + item.x) * 4],
+             &src[((size_t)(cellY + row) * image.width + cellX) * 4],
+             (size_t)item.cell.width * 4);
+    }
+  }
+
+  atlas.sprites.clear();
+  for (size_t i = 0; i < specs.size(); i++) {
+    if (specItems[i] == -1)
+      continue;
+    const SpriteSpec &spec = specs[i];
+    const PackItem &item = items[specItems[i]];
+
+    AtlasSprite sprite = {};
+    sprite.name = spec.name;
+    sprite.page = item.page;
+    sprite.source = {(float)item.x, (float)item.y, item.cell.width,
+                     item.cell.height};
+    sprite.hasCollision = spec.hasCollision;
+    if (spec.hasCollision)
+      sprite.collision = {spec.collision.x - item.cell.x,
+                          spec.collision.y - item.cell.y,
+                          spec.collision.width, spec.collision.height};
+    sprite.hasNPatch = spec.hasNPatch;
+    if (spec.hasNPatch) {
+      sprite.nPatch = spec.nPatch;
+      sprite.nPatch.source.x += item.x - item.cell.x;
+      sprite.nPatch.source.y += item.y - item.cell.y;
+    }
+    atlas.sprites.push_back(sprite);
+  }
+
+  for (auto &entry : images)
+    if (entry.second.data)
+      UnloadImage(entry.second);
+
+  TraceLog(LOG_INFO, "ATLAS: Packed %d sprites into %d page(s)",
+           (int)atlas.sprites.size(), (int)atlas.pages.size());
+  return !atlas.sprites.empty();
+}
+
+bool AtlasBuilder::LoadOrBuild(const std::string &cachePath, Atlas &atlas) {
+  std::vector<SpriteSpec> specs;
+  uint64_t sourceStamp = 0;
+  bool haveSources = ReadSpecs(specs, sourceStamp);
+
+  // Without sources (e.g. a packaged build) any readable cache is used
+  uint64_t cachedStamp = 0;
+  if (LoadCache(cachePath, atlas, cachedStamp) &&
+      (!haveSources || cachedStamp == sourceStamp))
+    return true;
+
+  if (!haveSources || !Build(atlas))
+    return false;
+
+  if (!SaveCache(cachePath, atlas, sourceStamp))
+    TraceLog(LOG_WARNING, "ATLAS: Could not write cache %s",
+             cachePath.c_str());
+  return true;
+}
+
+bool AtlasBuilder::SaveCache(const std::string &cachePath, const Atlas &atlas,
+                             uint64_t sourceStamp) {
+  FILE *file = fopen(cachePath.c_str(), "wb");
+  if (!file)
+    return false;
+
+  WriteValue(file, ATLAS_MAGIC);
+  WriteValue(file, ATLAS_VERSION);
+  WriteValue(file, sourceStamp);
+
+  WriteValue(file, (uint32_t)atlas.pages.size());
+  for (const AtlasPage &page : atlas.pages) {
+    WriteValue(file, (int32_t)page.width);
+    WriteValue(file, (int32_t)page.height);
+    fwrite(page.pixels.data(), 1, page.pixels.size(), file);
+  }
+
+  WriteValue(file, (uint32_t)atlas.sprites.size());
+  for (const AtlasSprite &sprite : atlas.sprites) {
+    WriteValue(file, (uint32_t)sprite.name.size());
+    fwrite(sprite.name.data(), 1, sprite.name.size(), file);
+    WriteValue(file, (int32_t)sprite.page);
+    WriteValue(file, sprite.source);
+    WriteValue(file, (uint8_t)sprite.hasCollision);
+    WriteValue(file, sprite.collision);
+    WriteValue(file, (uint8_t)sprite.hasNPatch);
+    WriteValue(file, sprite.nPatch);
+  }
+
+  bool ok = ferror(file) == 0;
+  fclose(file);
+  return ok;
+}
+
+bool AtlasBuilder::LoadCache(const std::string &cachePath, Atlas &atlas,
+                             uint64_t &sourceStamp) {
+  FILE *file = fopen(cachePath.c_str(), "rb");
+  if (!file)
+    return false;
+
+  uint32_t magic = 0, version = 0, count = 0;
+  bool ok = ReadValue(file, magic) && magic == ATLAS_MAGIC &&
+            ReadValue(file, version) && version == ATLAS_VERSION &&
+            ReadValue(file, sourceStamp) && ReadValue(file, count);
+
+  atlas.pages.clear();
+  for (uint32_t i = 0; ok && i < count; i++) {
+    int32_t width = 0, height = 0;
+    ok = ReadValue(file, width) && ReadValue(file, height) && width > 0 &&
+         height > 0;
+    if (!ok)
+      break;
+    AtlasPage page = {width, height, {}};
+    page.pixels.resize((size_t)width * height * 4);
+    ok = fread(page.pixels.data(), 1, page.pixels.size(), file) ==
+         page.pixels.size();
+    atlas.pages.push_back(std::move(page));
+  }
+
+  atlas.sprites.clear();
+  ok = ok && ReadValue(file, count);
+  for (uint32_t i = 0; ok && i < count; i++) {
+    AtlasSprite sprite = {};
+    uint32_t nameLength = 0;
+    int32_t page = 0;
+    uint8_t hasCollision = 0, hasNPatch = 0;
+    ok = ReadValue(file, nameLength) && nameLength < 256;
+    if (!ok)
+      break;
+    sprite.name.resize(nameLength);
+    ok = fread(&sprite.name[0], 1, nameLength, file) == nameLength &&
+         ReadValue(file, page) && ReadValue(file, sprite.source) &&
+         ReadValue(file, hasCollision) && ReadValue(file, sprite.collision) &&
+         ReadValue(file, hasNPatch) && ReadValue(file, sprite.nPatch) &&
+         page >= 0 && page < (int32_t)atlas.pages.size();
+    sprite.page = page;
+    sprite.hasCollision = hasCollision != 0;
+    sprite.hasNPatch = hasNPatch != 0;
+    atlas.sprites.push_back(sprite);
+  }
+
+  fclose(file);
+  if (!ok) {
+    atlas.pages.clear();
+    atlas.sprites.clear();
+  }
+  return ok;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AtlasSprite {
+  std::string name;
+  int page;
+  Rectangle source; // Cell in the atlas page
+  bool hasCollision;
+  Rectangle collision; // Relative to the cell
+  bool hasNPatch;
+  NPatchInfo nPatch; // Source rect in atlas page coordinates
+};
+
+// RGBA8 pixels of one packed page
+struct AtlasPage {
+  int width;
+  int height;
+  std::vector<unsigned char> pixels;
+};
+
+struct Atlas {
+  std::vector<AtlasPage> pages;
+  std::vector<AtlasSprite> sprites;
+};
+
+// Packs the sprites described by <assetsDir>/atlas.txt and the loose images
+// in <assetsDir>/sprites/ into one or more pages with a skyline packer.
+// The result is cached in a binary file stamped with the source file times,
+// so later runs reload it without decoding or packing anything.
+class AtlasBuilder {
+public:
+  AtlasBuilder(const std::string &assetsDir, int pageSize = 1024,
+               int padding = 1);
+
+  // Loads cachePath if it matches the sources, otherwise rebuilds it
+  bool LoadOrBuild(const std::string &cachePath, Atlas &atlas);
+  bool Build(Atlas &atlas);
+
+  static bool LoadCache(const std::string &cachePath, Atlas &atlas,
+                        uint64_t &sourceStamp);
+  static bool SaveCache(const std::string &cachePath, const Atlas &atlas,
+                        uint64_t sourceStamp);
+
+private:
+  struct SpriteSpec {
+    std::string name;
+    std::string imagePath;
+    Rectangle cell; // Whole image when width is 0
+    bool hasCollision;
+    Rectangle collision;
+    bool hasNPatch;
+    NPatchInfo nPatch;
+  };
+
+  std::string assetsDir;
+  int pageSize;
+  int padding;
+
+  bool ReadSpecs(std::vector<SpriteSpec> &specs, uint64_t &sourceStamp) const;
+};
@@ -15,9 +15,13 @@ enum class NodeType {
   ACTION_SHIELD,
   ACTION_SHIFT,
   POWER_DURATION_REDUCE,
-  POWER_VALUE_ADD
+  POWER_VALUE_ADD,
+  // New types go last, so build files, logs and stats keep their indices
+  ACTION_BURST
 };
 
+const int NODE_TYPE_COUNT = (int)NodeType::ACTION_BURST + 1;
+
 enum class NodeKind { CPU, ACTION, STAT, POWER };
 
 class BaseNode {
@@ -37,7 +41,6 @@ public:
   std::vector<int> connectedFromNodeIDs;
 
   float duration;
-  float currentActiveTimer;
   bool isCurrentlyActiveEffect;
 
   BaseNode(int _id = -1, NodeType _type = NodeType::NONE,
@@ -0,0 +1,150 @@
+#include "BatchRunner.h"
+#include "AllocTracker.h"
+#include "JobSystem.h"
+#include "raylib.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Action types get one histogram column each
+const NodeType ACTION_TYPES[] = {
+    NodeType::ACTION_FIRE, NodeType::ACTION_SHIELD, NodeType::ACTION_SHIFT,
+    NodeType::ACTION_BURST};
+
+// Estimate of the heap and inline size of one world after the build is
+// applied, which is what each worker keeps alive while a run plays. Summed
+// from container capacities and sizeof, so allocator overhead and the
+// small tables loaded at startup (waves, names) are left out.
+size_t EstimateFootprint(const GameWorld &world) {
+  size_t bytes = world.GetMemoryBytes();
+  bytes += world.player.inventoryStacks.capacity() * sizeof(InventoryStack);
+  for (const auto &node : world.player.placedNodes) {
+    bytes += sizeof(*node) + node->name.capacity() +
+             node->description.capacity();
+    bytes += (node->connectedToNodeIDs.capacity() +
+              node->connectedFromNodeIDs.capacity()) *
+             sizeof(int);
+  }
+  // Templates are one node of each type
+  bytes += (NODE_TYPE_COUNT - 1) * sizeof(BaseNode);
+  return bytes;
+}
+
+bool WriteResults(const std::string &path,
+                  const std::vector<RunResult> &results) {
+  bool toStdout = path == "-";
+  FILE *file = toStdout ? stdout : fopen(path.c_str(), "w");
+  if (!file)
+    return false;
+
+  fprintf(file, "seed,survival_s,died,kills,wave,dps,damage_taken");
+  for (NodeType type : ACTION_TYPES)
+    fprintf(file, ",activations_%s",
+            type == NodeType::ACTION_FIRE     ? "fire"
+            : type == NodeType::ACTION_SHIELD ? "shield"
+            : type == NodeType::ACTION_SHIFT  ? "shift"
+                                              : "burst");
+  fprintf(file, "\n");
+
+  for (const RunResult &result : results) {
+    float dps = result.survival > 0.0f ? result.damageDealt / result.survival
+                                       : 0.0f;
+    fprintf(file, "%llu,%.3f,%d,%d,%d,%.2f,%d",
+            (unsigned long long)result.seed, result.survival,
+            result.died ? 1 : 0, result.kills, result.wave, dps,
+            result.damageTaken);
+    for (NodeType type : ACTION_TYPES)
+      fprintf(file, ",%d", result.activations[(int)type]);
+    fprintf(file, "\n");
+  }
+
+  if (!toStdout)
+    fclose(file);
+  return true;
+}
+
+} // namespace
+
+RunResult PlayHeadlessRun(const BuildSpec &spec, int width, int height,
+                          float duration, uint64_t seed, float tick) {
+  GameWorld world(width, height);
+  world.Seed(seed);
+  world.Init();
+  ApplyBuildSpec(spec, world);
+  world.state = GameState::GAMEPLAY;
+
+  while (world.state == GameState::GAMEPLAY &&
+         world.GetStats().elapsed < duration)
+    world.Tick(DecideBotInput(spec.policy, world), tick);
+
+  const RunStats &stats = world.GetStats();
+  RunResult result;
+  result.seed = seed;
+  result.survival = stats.elapsed;
+  result.died = world.state == GameState::GAME_OVER;
+  result.kills = stats.kills;
+  result.wave = stats.wave;
+  result.damageDealt = stats.damageDealt;
+  result.damageTaken = stats.damageTaken;
+  for (int i = 0; i < NODE_TYPE_COUNT; i++)
+    result.activations[i] = stats.activations[i];
+  return result;
+}
+
+int RunBatch(const BatchOptions &options) {
+  BuildSpec spec;
+  if (!LoadBuildSpec(options.buildPath, spec))
+    return 1;
+  float duration = options.duration > 0.0f ? options.duration : spec.duration;
+
+  // Check the wiring once up front; every run applies it the same way
+  size_t footprint;
+  AllocCounts built;
+  {
+    AllocTracker::TakeTotals();
+    GameWorld probe(options.width, options.height);
+    probe.Init();
+    if (!ApplyBuildSpec(spec, probe))
+      return 1;
+    built = AllocTracker::TakeTotals();
+    footprint = EstimateFootprint(probe);
+  }
+
+  JobSystem jobs(options.workerCount);
+  std::vector<RunResult> results(options.runs);
+
+  fprintf(stderr,
+          "batch: %d runs of up to %.0f s (%s) at %d Hz on %d threads, "
+          "an estimated %.1f KB per run, %.1f KB for 64 concurrent\n",
+          options.runs, duration, GetBotPolicyName(spec.policy),
+          options.tickRate, jobs.GetWorkerCount(), footprint / 1024.0,
+          footprint * 64 / 1024.0);
+  // With the allocation hooks in, back the estimate with what setting up a
+  // world actually asked the heap for (requested sizes, frees not netted)
+  if (AllocTracker::IsEnabled())
+    fprintf(stderr,
+            "batch: setting up a world allocated %.1f KB in %llu "
+            "allocations\n",
+            built.bytes / 1024.0, (unsigned long long)built.allocations);
+
+  auto start = std::chrono::steady_clock::now();
+  jobs.ParallelFor(options.runs, 1, [&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      results[i] = PlayHeadlessRun(spec, options.width, options.height,
+                                   duration, options.firstSeed + (uint64_t)i,
+                                   1.0f / options.tickRate);
+  });
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  fprintf(stderr, "batch: finished in %.2f s\n", seconds);
+
+  if (!WriteResults(options.outputPath, results)) {
+    TraceLog(LOG_WARNING, "BATCH: could not write %s",
+             options.outputPath.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "BuildSpec.h"
+#include <cstdint>
+#include <string>
+
+struct BatchOptions {
+  std::string buildPath;        // BuildSpec file every run starts from
+  std::string outputPath = "-"; // CSV destination, '-' for stdout
+  int runs = 1000;
+  uint64_t firstSeed = 1; // Run i is seeded with firstSeed + i
+  float duration = 0.0f;  // Overrides the build's duration when positive
+  int workerCount = 0;    // 0 for one per hardware thread
+  int tickRate = 60;      // Simulation steps per second
+  int width = 1600;
+  int height = 1200;
+};
+
+// Plays every run headless at a fixed tick, spread over all cores, and
+// writes one CSV row per run. Only one world per worker is alive at a
+// time. Returns a process exit code.
+int RunBatch(const BatchOptions &options);
+
+// Outcome of one headless run
+struct RunResult {
+  uint64_t seed;
+  float survival; // Seconds until death or the duration cut-off
+  bool died;
+  int kills;
+  int wave; // Waves reached
+  int damageDealt;
+  int damageTaken;
+  int activations[NODE_TYPE_COUNT]; // Action starts, indexed by NodeType
+};
+
+// Plays one seeded run of spec with its bot policy. Self-contained, so any
+// number can run at once on different threads.
+RunResult PlayHeadlessRun(const BuildSpec &spec, int width, int height,
+                          float duration, uint64_t seed,
+                          float tick = 1.0f / 60.0f);
@@ -0,0 +1,72 @@
+#include "BotPolicy.h"
+#include "raymath.h"
+#include <cstring>
+
+const char *GetBotPolicyName(BotPolicy policy) {
+  switch (policy) {
+  case BotPolicy::IDLE:
+    return "idle";
+  case BotPolicy::KITE:
+    return "kite";
+  case BotPolicy::STRAFE:
+    return "strafe";
+  }
+  return "unknown";
+}
+
+bool ParseBotPolicy(const char *name, BotPolicy &policy) {
+  const BotPolicy policies[] = {BotPolicy::IDLE, BotPolicy::KITE,
+                                BotPolicy::STRAFE};
+  for (BotPolicy candidate : policies) {
+    if (strcmp(name, GetBotPolicyName(candidate)) == 0) {
+      policy = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+static const EnemyBody *FindNearestEnemy(const GameWorld &world) {
+  const EnemyBody *nearest = nullptr;
+  float nearestDistance = 0.0f;
+  world.enemies.ForEachAlive(
+      [&](int, const EnemyBody &body, const EnemyGun &) {
+        float distance =
+            Vector2DistanceSqr(world.player.position, body.position);
+        if (!nearest || distance < nearestDistance) {
+          nearest = &body;
+          nearestDistance = distance;
+        }
+      });
+  return nearest;
+}
+
+PlayerInput DecideBotInput(BotPolicy policy, const GameWorld &world) {
+  PlayerInput input = {};
+  Vector2 position = world.player.position;
+  const EnemyBody *target = FindNearestEnemy(world);
+  input.aimPosition =
+      target ? target->position : Vector2{position.x, position.y - 100.0f};
+
+  switch (policy) {
+  case BotPolicy::IDLE:
+    break;
+  case BotPolicy::KITE:
+    input.fireHeld = target != nullptr;
+    if (target)
+      input.moveDir =
+          Vector2Normalize(Vector2Subtract(position, target->position));
+    break;
+  case BotPolicy::STRAFE: {
+    input.fireHeld = target != nullptr;
+    // Sweep direction flips every 2.5 seconds of play
+    bool right = ((int)(world.GetStats().elapsed / 2.5f) % 2) == 0;
+    input.moveDir.x = right ? 1.0f : -1.0f;
+    // Hold the bottom fifth of the arena
+    if (position.y < world.GetHeight() * 0.8f)
+      input.moveDir.y = 1.0f;
+    break;
+  }
+  }
+  return input;
+}
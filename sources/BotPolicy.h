@@ -0,0 +1,16 @@
+#pragma once
+#include "GameWorld.h"
+
+// Scripted stand-ins for the player, used by headless batch runs. Every
+// policy aims at the nearest enemy; they differ in how they move and shoot.
+enum class BotPolicy {
+  IDLE,   // Stands still and leaves firing to the node graph
+  KITE,   // Backs away from the nearest enemy, shooting
+  STRAFE, // Sweeps side to side along the bottom, shooting
+};
+
+const char *GetBotPolicyName(BotPolicy policy);
+bool ParseBotPolicy(const char *name, BotPolicy &policy);
+
+// Pure function of the world, so a seeded run replays exactly
+PlayerInput DecideBotInput(BotPolicy policy, const GameWorld &world);
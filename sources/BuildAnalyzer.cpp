@@ -0,0 +1,120 @@
+#include "BuildAnalyzer.h"
+#include "NodeTypes.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Whole ticks a countdown from duration lasts, counted with the same float
+// steps as the manual fire cooldown
+static int CountdownTicks(float duration, float dt) {
+  int ticks = 0;
+  for (float timer = duration; timer > 0 && ticks < 100000; timer -= dt)
+    ticks++;
+  return ticks;
+}
+
+// Ticks from an action starting to the next one starting. The scheduler
+// parks it until the first tick that starts duration after this one ends.
+static int ActionTicks(float duration, float dt) {
+  return (int)ceil((duration - ACTION_CLOCK_EPSILON) / dt) + 1;
+}
+
+static const BaseNode *NextAction(const Player &player,
+                                  const BaseNode &action) {
+  for (int connectedId : action.connectedToNodeIDs) {
+    BaseNode *next = player.GetPlayerNodeById(connectedId);
+    if (next && next->getNodeKind() == NodeKind::ACTION)
+      return next;
+  }
+  return &action;
+}
+
+BuildEstimate AnalyzeBuild(const Player &player,
+                           const NodesController &nodesController, float dt) {
+  BuildEstimate estimate = {};
+  PlayerStats stats = player.CalculateNodeStats();
+
+  // Manual fire: the cooldown restarts at the fire rate and a shot goes out
+  // on the tick it reaches zero
+  float shotInterval = CountdownTicks(stats.fireRate, dt) * dt;
+  estimate.manualDps = shotInterval > 0 ? stats.damage / shotInterval : 0;
+
+  const BaseNode *start = nullptr;
+  if (const BaseNode *cpuNode = player.GetPlayerNodeById(0)) {
+    for (int connectedId : cpuNode->connectedToNodeIDs) {
+      BaseNode *node = player.GetPlayerNodeById(connectedId);
+      if (node && node->getNodeKind() == NodeKind::ACTION) {
+        start = node;
+        break;
+      }
+    }
+  }
+
+  // Follow the sequence until an action repeats; from there it cycles
+  std::vector<const BaseNode *> sequence;
+  size_t cycleStart = 0;
+  for (const BaseNode *action = start; action;
+       action = NextAction(player, *action)) {
+    auto seen = std::find(sequence.begin(), sequence.end(), action);
+    if (seen != sequence.end()) {
+      cycleStart = seen - sequence.begin();
+      break;
+    }
+    sequence.push_back(action);
+  }
+
+  float blastDamageTotal = 0.0f;
+  float shieldTime = 0.0f;
+  float shiftTime = 0.0f;
+  float shiftBonusTime = 0.0f;
+  for (size_t i = cycleStart; i < sequence.size(); i++) {
+    const BaseNode *action = sequence[i];
+    float duration = fmaxf(
+        0.1f, nodesController.CalculateEffectiveDuration(action, player));
+    // A burst waits once per shot, each wait rounded up to whole ticks
+    float activeTime =
+        action->getNodeType() == NodeType::ACTION_BURST
+            ? BURST_SHOTS * ActionTicks(duration / BURST_SHOTS, dt) * dt
+            : ActionTicks(duration, dt) * dt;
+    estimate.cycleTime += activeTime;
+    estimate.rotationLength++;
+
+    switch (action->getNodeType()) {
+    case NodeType::ACTION_FIRE:
+    case NodeType::ACTION_BURST: {
+      float blast = (float)(stats.damage +
+                            (int)nodesController.CalculateFireBonus(*action,
+                                                                    player));
+      estimate.blastDamage = blast;
+      blastDamageTotal +=
+          action->getNodeType() == NodeType::ACTION_BURST ? BURST_SHOTS * blast
+                                                          : blast;
+      break;
+    }
+    case NodeType::ACTION_SHIELD:
+      shieldTime += activeTime;
+      break;
+    case NodeType::ACTION_SHIFT:
+      shiftTime += activeTime;
+      shiftBonusTime += activeTime * player.CalculateShiftBonus(*action);
+      break;
+    default:
+      break;
+    }
+  }
+
+  estimate.averageSpeed = stats.speed;
+  if (estimate.cycleTime > 0) {
+    estimate.actionDps = blastDamageTotal / estimate.cycleTime;
+    estimate.shieldUptime = shieldTime / estimate.cycleTime;
+    estimate.shiftUptime = shiftTime / estimate.cycleTime;
+    estimate.averageSpeed += shiftBonusTime / estimate.cycleTime;
+  }
+
+  // Contact damage only lands while the shield is down
+  estimate.effectiveHealth =
+      estimate.shieldUptime < 1.0f
+          ? stats.maxHealth / (1.0f - estimate.shieldUptime)
+          : INFINITY;
+  return estimate;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "NodesController.h"
+#include "Player.h"
+
+// Steady-state figures for a wired graph, derived from the node rules
+// instead of simulated. Assumes every shot is fired and none miss.
+struct BuildEstimate {
+  int rotationLength;    // Actions in the repeating part of the sequence
+  float cycleTime;       // Seconds per rotation, 0 without actions
+  float blastDamage;     // Per blast or burst shot, 0 without either
+  float actionDps;       // Blasts and burst shots over the rotation
+  float manualDps;       // Fire button held at the current fire rate
+  float shieldUptime;    // Fraction of time the shield is up
+  float shiftUptime;     // Fraction of time the shift bonus applies
+  float averageSpeed;    // Speed stat plus the shift bonus times its uptime
+  float effectiveHealth; // Max health over the unshielded fraction
+};
+
+// Walks the action sequence from the core the way NodesController does:
+// each action hands over to its ACTION successor or repeats itself, so the
+// rotation ends in a cycle. Durations are rounded to whole ticks of dt like
+// the tick does. Reads only graph structure and node tuning, so it is safe
+// on the main thread while the simulation runs, and takes microseconds.
+BuildEstimate AnalyzeBuild(const Player &player,
+                           const NodesController &nodesController,
+                           float dt = 1.0f / 60.0f);
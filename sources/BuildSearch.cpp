@@ -0,0 +1,304 @@
+#include "BuildSearch.h"
+#include "BatchRunner.h"
+#include "JobSystem.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Links as (from, to) pool indices, sorted. Index 0 is always the core.
+typedef std::vector<std::pair<int, int>> EdgeList;
+
+struct Candidate {
+  EdgeList edges;
+  uint64_t key;
+  float score;
+};
+
+uint64_t Mix(uint64_t hash, uint64_t value) {
+  // splitmix64 finaliser over the running hash
+  uint64_t x = hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6));
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// Nodes of the same type are interchangeable, so the key must not depend on
+// which one got which index. Three rounds of neighbourhood refinement tell
+// apart every wiring these rules allow at pool sizes we search.
+uint64_t CanonicalKey(const std::vector<NodeType> &types,
+                      const EdgeList &edges) {
+  size_t count = types.size();
+  std::vector<uint64_t> labels(count);
+  for (size_t i = 0; i < count; i++)
+    labels[i] = Mix(0, (uint64_t)types[i]);
+
+  std::vector<std::vector<uint64_t>> outgoing(count), incoming(count);
+  std::vector<uint64_t> refined(count);
+  for (int round = 0; round < 3; round++) {
+    for (size_t i = 0; i < count; i++) {
+      outgoing[i].clear();
+      incoming[i].clear();
+    }
+    for (const auto &edge : edges) {
+      outgoing[edge.first].push_back(labels[edge.second]);
+      incoming[edge.second].push_back(labels[edge.first]);
+    }
+    for (size_t i = 0; i < count; i++) {
+      std::sort(outgoing[i].begin(), outgoing[i].end());
+      std::sort(incoming[i].begin(), incoming[i].end());
+      uint64_t hash = Mix(labels[i], outgoing[i].size());
+      for (uint64_t label : outgoing[i])
+        hash = Mix(hash, label);
+      hash = Mix(hash, incoming[i].size());
+      for (uint64_t label : incoming[i])
+        hash = Mix(hash, label);
+      refined[i] = hash;
+    }
+    labels.swap(refined);
+  }
+
+  std::sort(labels.begin(), labels.end());
+  uint64_t key = Mix(0, edges.size());
+  for (uint64_t label : labels)
+    key = Mix(key, label);
+  return key;
+}
+
+// One placed node per pool entry, rewired from an edge list on demand so
+// neighbours are generated by the same rules the panel uses
+class ScratchGraph {
+public:
+  explicit ScratchGraph(const std::vector<NodeType> &types) {
+    controller.Initialize();
+    // A fresh controller hands out ids from 0, so ids match pool indices
+    for (NodeType type : types) {
+      auto node = controller.CreateNodeFromTemplate(type);
+      node->isPlaced = true;
+      player.placedNodes.push_back(std::move(node));
+    }
+  }
+
+  void Load(const EdgeList &edges) {
+    for (auto &node : player.placedNodes) {
+      node->connectedToNodeIDs.clear();
+      node->connectedFromNodeIDs.clear();
+    }
+    for (const auto &edge : edges)
+      controller.ConnectNodes(player, edge.first, edge.second);
+  }
+
+  bool Connect(int from, int to) {
+    return controller.ConnectNodes(player, from, to);
+  }
+
+  EdgeList GetEdges() const {
+    EdgeList edges;
+    for (const auto &node : player.placedNodes)
+      for (int to : node->connectedToNodeIDs)
+        edges.push_back({node->id, to});
+    std::sort(edges.begin(), edges.end());
+    return edges;
+  }
+
+private:
+  NodesController controller;
+  Player player;
+};
+
+std::string NodeLabel(int index) { return "n" + std::to_string(index); }
+
+BuildSpec MakeCandidateSpec(const BuildSpec &pool,
+                            const std::vector<NodeType> &types,
+                            const EdgeList &edges, float duration) {
+  BuildSpec spec;
+  spec.policy = pool.policy;
+  spec.duration = duration;
+  spec.replaceInventory = true;
+  for (size_t i = 1; i < types.size(); i++)
+    spec.nodes.push_back({NodeLabel((int)i), types[i]});
+  for (const auto &edge : edges)
+    spec.links.push_back({edge.first == 0 ? "cpu" : NodeLabel(edge.first),
+                          NodeLabel(edge.second)});
+  return spec;
+}
+
+} // namespace
+
+BuildSpec SearchBestBuild(const BuildSpec &pool, const SearchOptions &options,
+                          JobSystem &jobs) {
+  // Pool: the core, then placed nodes, then the inventory
+  std::vector<NodeType> types = {NodeType::CPU_CORE};
+  std::map<std::string, int> labels = {{"cpu", 0}};
+  for (const BuildSpec::Node &node : pool.nodes) {
+    if ((int)types.size() > options.maxNodes)
+      break;
+    labels[node.label] = (int)types.size();
+    types.push_back(node.type);
+  }
+  for (const InventoryStack &stack : pool.inventory)
+    for (int i = 0; i < stack.count && (int)types.size() <= options.maxNodes;
+         i++)
+      types.push_back(stack.type);
+  int nodeCount = (int)types.size();
+
+  ScratchGraph graph(types);
+  std::vector<Candidate> beam(1);
+  beam[0].edges = EdgeList();
+  // The pool's own wiring is a second starting point
+  graph.Load(EdgeList());
+  for (const BuildSpec::Link &link : pool.links) {
+    auto from = labels.find(link.from);
+    auto to = labels.find(link.to);
+    if (from != labels.end() && to != labels.end())
+      graph.Connect(from->second, to->second);
+  }
+  if (!graph.GetEdges().empty())
+    beam.push_back({graph.GetEdges(), 0, 0.0f});
+
+  std::unordered_map<uint64_t, float> scores;
+  int simulated = 0;
+  int memoHits = 0;
+  float bestScore = -1e30f;
+
+  for (int step = 0; step < options.maxSteps; step++) {
+    // Current beam plus every one-link change of it, deduplicated by key
+    std::vector<Candidate> candidates;
+    std::unordered_map<uint64_t, bool> seen;
+    auto addCandidate = [&](EdgeList edges) {
+      uint64_t key = CanonicalKey(types, edges);
+      if (seen.count(key))
+        return;
+      seen[key] = true;
+      candidates.push_back({std::move(edges), key, 0.0f});
+    };
+    for (const Candidate &parent : beam) {
+      addCandidate(parent.edges);
+      for (int from = 0; from < nodeCount; from++) {
+        for (int to = 0; to < nodeCount; to++) {
+          graph.Load(parent.edges);
+          if (graph.Connect(from, to))
+            addCandidate(graph.GetEdges());
+        }
+      }
+      for (size_t i = 0; i < parent.edges.size(); i++) {
+        EdgeList edges = parent.edges;
+        edges.erase(edges.begin() + i);
+        addCandidate(edges);
+      }
+    }
+
+    // Simulate only wirings never scored before, all seeds in one pass
+    std::vector<int> pending;
+    for (int i = 0; i < (int)candidates.size(); i++) {
+      auto cached = scores.find(candidates[i].key);
+      if (cached != scores.end()) {
+        candidates[i].score = cached->second;
+        memoHits++;
+      } else {
+        pending.push_back(i);
+      }
+    }
+
+    int seeds = options.seedsPerCandidate;
+    std::vector<BuildSpec> specs(pending.size());
+    for (size_t p = 0; p < pending.size(); p++)
+      specs[p] = MakeCandidateSpec(pool, types, candidates[pending[p]].edges,
+                                   options.evalDuration);
+    std::vector<int> netDamage(pending.size() * seeds);
+    jobs.ParallelFor((int)netDamage.size(), 1, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        RunResult result = PlayHeadlessRun(
+            specs[i / seeds], options.width, options.height,
+            options.evalDuration, options.firstSeed + (uint64_t)(i % seeds));
+        netDamage[i] = result.damageDealt - result.damageTaken;
+      }
+    });
+    simulated += (int)netDamage.size();
+
+    // Net damage per second, averaged over the seeds. Dying early cuts the
+    // damage dealt short, so survival is already part of it.
+    for (size_t p = 0; p < pending.size(); p++) {
+      long long total = 0;
+      for (int s = 0; s < seeds; s++)
+        total += netDamage[p * seeds + s];
+      Candidate &candidate = candidates[pending[p]];
+      candidate.score =
+          (float)total / (float)seeds / std::max(options.evalDuration, 1.0f);
+      scores[candidate.key] = candidate.score;
+    }
+
+    // Ties go to the simpler wiring, then the key, so the result is stable
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b) {
+                if (a.score != b.score)
+                  return a.score > b.score;
+                if (a.edges.size() != b.edges.size())
+                  return a.edges.size() < b.edges.size();
+                return a.key < b.key;
+              });
+    if ((int)candidates.size() > options.beamWidth)
+      candidates.resize(options.beamWidth);
+    beam = std::move(candidates);
+
+    fprintf(stderr,
+            "search: step %d, %zu new wirings, best %.2f net dps "
+            "(%d runs, %d memo hits)\n",
+            step + 1, pending.size(), beam[0].score, simulated, memoHits);
+    if (beam[0].score <= bestScore)
+      break;
+    bestScore = beam[0].score;
+  }
+
+  // Place only what the best wiring uses
+  const EdgeList &best = beam[0].edges;
+  std::vector<bool> used(nodeCount, false);
+  for (const auto &edge : best)
+    used[edge.first] = used[edge.second] = true;
+
+  BuildSpec result;
+  result.policy = pool.policy;
+  result.duration = pool.duration;
+  result.replaceInventory = true;
+  std::vector<std::string> names(nodeCount, "cpu");
+  std::map<NodeType, int> leftovers;
+  for (int i = 1; i < nodeCount; i++) {
+    if (!used[i]) {
+      leftovers[types[i]]++;
+      continue;
+    }
+    names[i] = NodeLabel(i);
+    result.nodes.push_back({names[i], types[i]});
+  }
+  for (const auto &leftover : leftovers)
+    result.inventory.push_back({leftover.first, leftover.second});
+  for (const auto &edge : best)
+    result.links.push_back({names[edge.first], names[edge.second]});
+  return result;
+}
+
+int RunBuildSearch(const std::string &poolPath, const std::string &outputPath,
+                   const SearchOptions &options, int workerCount) {
+  BuildSpec pool;
+  if (!LoadBuildSpec(poolPath, pool))
+    return 1;
+
+  JobSystem jobs(workerCount);
+  fprintf(stderr,
+          "search: beam %d, %d seeds of %.0f s per wiring (%s) on %d "
+          "threads\n",
+          options.beamWidth, options.seedsPerCandidate, options.evalDuration,
+          GetBotPolicyName(pool.policy), jobs.GetWorkerCount());
+  BuildSpec best = SearchBestBuild(pool, options, jobs);
+
+  if (!SaveBuildSpec(outputPath, best)) {
+    TraceLog(LOG_WARNING, "SEARCH: could not write %s", outputPath.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "BuildSpec.h"
+#include <cstdint>
+#include <string>
+
+class JobSystem;
+
+struct SearchOptions {
+  int beamWidth = 4;         // Wirings kept between steps
+  int maxSteps = 12;         // Stops earlier once the best stops improving
+  int seedsPerCandidate = 8; // Runs averaged into each score
+  float evalDuration = 30.0f;
+  uint64_t firstSeed = 1; // Every candidate plays the same seeds
+  int maxNodes = 12;      // Pool cap, not counting the core
+  int width = 1600;
+  int height = 1200;
+};
+
+// Beam search over legal wirings of the nodes in pool (its placed nodes
+// plus its inventory). Neighbours add one link through
+// NodesController::ConnectNodes, so the panel's rules (one ACTION per CPU,
+// one successor per ACTION, one target per POWER) hold by construction, or
+// drop one link. Candidates are scored by short headless runs on the job
+// system and memoised by a canonical hash of the wiring, so the same graph
+// reached with nodes in a different order isn't simulated twice.
+//
+// Returns the best build: linked nodes placed, the rest left in inventory.
+BuildSpec SearchBestBuild(const BuildSpec &pool, const SearchOptions &options,
+                          JobSystem &jobs);
+
+// --suggest mode: searches the build in poolPath and saves the best wiring
+// to outputPath ('-' for stdout). Returns a process exit code.
+int RunBuildSearch(const std::string &poolPath, const std::string &outputPath,
+                   const SearchOptions &options, int workerCount);
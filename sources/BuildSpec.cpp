@@ -0,0 +1,229 @@
+#include "BuildSpec.h"
+#include "GameRandom.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace {
+
+struct NodeTypeName {
+  const char *name;
+  NodeType type;
+};
+
+const NodeTypeName NODE_TYPE_NAMES[] = {
+    {"cpu", NodeType::CPU_CORE},
+    {"health", NodeType::STAT_HEALTH},
+    {"speed", NodeType::STAT_SPEED},
+    {"damage", NodeType::STAT_DAMAGE},
+    {"fire_rate", NodeType::STAT_FIRE_RATE},
+    {"fire", NodeType::ACTION_FIRE},
+    {"shield", NodeType::ACTION_SHIELD},
+    {"shift", NodeType::ACTION_SHIFT},
+    {"burst", NodeType::ACTION_BURST},
+    {"duration_reduce", NodeType::POWER_DURATION_REDUCE},
+    {"value_add", NodeType::POWER_VALUE_ADD},
+};
+
+bool ParseNodeType(const std::string &name, NodeType &type) {
+  for (const NodeTypeName &entry : NODE_TYPE_NAMES) {
+    if (name == entry.name) {
+      type = entry.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *GetNodeTypeName(NodeType type) {
+  for (const NodeTypeName &entry : NODE_TYPE_NAMES)
+    if (entry.type == type)
+      return entry.name;
+  return "none";
+}
+
+// Grid spacing for placed nodes, so the build still reads in the panel
+const float NODE_SPACING = 80.0f;
+// Tries at a legal link per random node, and spare links per node
+const int LINK_ATTEMPTS = 8;
+const float EXTRA_LINKS_PER_NODE = 0.5f;
+
+} // namespace
+
+bool LoadBuildSpec(const std::string &path, BuildSpec &spec) {
+  char *text = LoadFileText(path.c_str());
+  if (!text) {
+    TraceLog(LOG_WARNING, "BUILD: could not read %s", path.c_str());
+    return false;
+  }
+
+  spec = BuildSpec();
+  bool valid = true;
+  std::istringstream lines(text);
+  UnloadFileText(text);
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line)) {
+    lineNumber++;
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword[0] == '#')
+      continue;
+
+    bool entryValid = true;
+    if (keyword == "policy") {
+      std::string name;
+      entryValid =
+          (tokens >> name) && ParseBotPolicy(name.c_str(), spec.policy);
+    } else if (keyword == "duration") {
+      entryValid = (tokens >> spec.duration) && spec.duration > 0.0f;
+    } else if (keyword == "inventory") {
+      std::string name;
+      InventoryStack stack = {NodeType::NONE, 1};
+      entryValid = (tokens >> name) && ParseNodeType(name, stack.type) &&
+                   stack.type != NodeType::CPU_CORE;
+      if (entryValid && (tokens >> stack.count))
+        entryValid = stack.count > 0;
+      if (entryValid) {
+        spec.replaceInventory = true;
+        spec.inventory.push_back(stack);
+      }
+    } else if (keyword == "node") {
+      BuildSpec::Node node;
+      std::string name;
+      entryValid = (tokens >> node.label >> name) &&
+                   ParseNodeType(name, node.type) &&
+                   node.type != NodeType::CPU_CORE && node.label != "cpu";
+      if (entryValid)
+        spec.nodes.push_back(node);
+    } else if (keyword == "link") {
+      BuildSpec::Link link;
+      entryValid = (bool)(tokens >> link.from >> link.to);
+      if (entryValid)
+        spec.links.push_back(link);
+    } else {
+      TraceLog(LOG_WARNING, "BUILD: %s:%d: unknown entry '%s'", path.c_str(),
+               lineNumber, keyword.c_str());
+      valid = false;
+      continue;
+    }
+
+    if (!entryValid) {
+      TraceLog(LOG_WARNING, "BUILD: %s:%d: malformed %s entry", path.c_str(),
+               lineNumber, keyword.c_str());
+      valid = false;
+    }
+  }
+  return valid;
+}
+
+bool SaveBuildSpec(const std::string &path, const BuildSpec &spec) {
+  bool toStdout = path == "-";
+  FILE *file = toStdout ? stdout : fopen(path.c_str(), "w");
+  if (!file)
+    return false;
+
+  fprintf(file, "policy %s\n", GetBotPolicyName(spec.policy));
+  fprintf(file, "duration %g\n", spec.duration);
+  for (const InventoryStack &stack : spec.inventory)
+    fprintf(file, "inventory %s %d\n", GetNodeTypeName(stack.type),
+            stack.count);
+  for (const BuildSpec::Node &node : spec.nodes)
+    fprintf(file, "node %s %s\n", node.label.c_str(),
+            GetNodeTypeName(node.type));
+  for (const BuildSpec::Link &link : spec.links)
+    fprintf(file, "link %s %s\n", link.from.c_str(), link.to.c_str());
+
+  if (!toStdout)
+    fclose(file);
+  return true;
+}
+
+bool ApplyBuildSpec(const BuildSpec &spec, GameWorld &world) {
+  Player &player = world.player;
+  NodesController &nodesController = world.nodesController;
+
+  if (spec.replaceInventory) {
+    player.inventoryStacks.clear();
+    for (const InventoryStack &stack : spec.inventory)
+      player.AddInventoryNode(stack.type, stack.count);
+  }
+
+  // The core placed by Init is always available as "cpu"
+  std::map<std::string, int> labels;
+  for (const auto &node : player.placedNodes)
+    if (node->getNodeType() == NodeType::CPU_CORE)
+      labels["cpu"] = node->id;
+
+  for (size_t i = 0; i < spec.nodes.size(); i++) {
+    const BuildSpec::Node &node = spec.nodes[i];
+    auto placed = nodesController.CreateNodeFromTemplate(node.type);
+    placed->isPlaced = true;
+    placed->panelPosition = {NODE_SPACING * (float)(i % 4 + 1),
+                             NODE_SPACING * (float)(i / 4)};
+    labels[node.label] = placed->id;
+    player.placedNodes.push_back(std::move(placed));
+  }
+
+  bool valid = true;
+  for (const BuildSpec::Link &link : spec.links) {
+    auto from = labels.find(link.from);
+    auto to = labels.find(link.to);
+    if (from == labels.end() || to == labels.end()) {
+      TraceLog(LOG_WARNING, "BUILD: link %s -> %s names an unknown node",
+               link.from.c_str(), link.to.c_str());
+      valid = false;
+    } else if (!nodesController.ConnectNodes(player, from->second,
+                                             to->second)) {
+      TraceLog(LOG_WARNING, "BUILD: link %s -> %s is not allowed",
+               link.from.c_str(), link.to.c_str());
+      valid = false;
+    }
+  }
+
+  nodesController.UpdateNodeActivation(player);
+  player.currentHealth = player.maxHealth;
+  return valid;
+}
+
+void PlaceRandomGraph(GameWorld &world, int nodeCount, uint64_t seed) {
+  Player &player = world.player;
+  NodesController &nodesController = world.nodesController;
+  GameRandom random(seed);
+
+  // Square-ish grid to the right of the core
+  int columns = std::max(4, (int)ceilf(sqrtf((float)nodeCount)));
+  for (int i = 0; i < nodeCount; i++) {
+    NodeType type = (NodeType)random.Range((int)NodeType::STAT_HEALTH,
+                                           NODE_TYPE_COUNT - 1);
+    auto placed = nodesController.CreateNodeFromTemplate(type);
+    placed->isPlaced = true;
+    placed->panelPosition = {NODE_SPACING * (float)(i % columns + 1),
+                             NODE_SPACING * (float)(i / columns)};
+    int id = placed->id;
+    int earlier = (int)player.placedNodes.size();
+    player.placedNodes.push_back(std::move(placed));
+    for (int attempt = 0; attempt < LINK_ATTEMPTS; attempt++) {
+      int from = player.placedNodes[random.Range(0, earlier - 1)]->id;
+      if (nodesController.ConnectNodes(player, from, id))
+        break;
+    }
+  }
+
+  int total = (int)player.placedNodes.size();
+  int extraLinks = (int)(nodeCount * EXTRA_LINKS_PER_NODE);
+  for (int i = 0; i < extraLinks * LINK_ATTEMPTS && extraLinks > 0; i++) {
+    int from = player.placedNodes[random.Range(0, total - 1)]->id;
+    int to = player.placedNodes[random.Range(0, total - 1)]->id;
+    if (from != to && nodesController.ConnectNodes(player, from, to))
+      extraLinks--;
+  }
+
+  nodesController.UpdateNodeActivation(player);
+  player.currentHealth = player.maxHealth;
+}
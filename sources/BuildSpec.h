@@ -0,0 +1,46 @@
+#pragma once
+#include "BotPolicy.h"
+#include "Player.h"
+#include <string>
+#include <vector>
+
+// A starting loadout for headless runs, read from a plain-text file:
+//
+//   policy kite                  # idle, kite or strafe
+//   duration 120                 # seconds before a run is cut off
+//   inventory shield 2           # replaces the default inventory
+//   node gun fire                # places a node under a label
+//   link cpu gun                 # connects two labels; "cpu" is the core
+//
+// Node types use the short names listed in NODE_TYPE_NAMES.
+struct BuildSpec {
+  struct Node {
+    std::string label;
+    NodeType type;
+  };
+  struct Link {
+    std::string from;
+    std::string to;
+  };
+
+  BotPolicy policy = BotPolicy::KITE;
+  float duration = 120.0f;
+  bool replaceInventory = false;
+  std::vector<InventoryStack> inventory;
+  std::vector<Node> nodes;
+  std::vector<Link> links;
+};
+
+// Returns false when the file can't be read or has malformed entries
+bool LoadBuildSpec(const std::string &path, BuildSpec &spec);
+// Writes spec in the same format; '-' writes to stdout
+bool SaveBuildSpec(const std::string &path, const BuildSpec &spec);
+
+// Lays the build out on a freshly initialised world. Returns false (after
+// logging) if a link names an unknown label or breaks the wiring rules.
+bool ApplyBuildSpec(const BuildSpec &spec, GameWorld &world);
+
+// Places nodeCount nodes of random kinds (no cores) on a freshly
+// initialised world and wires them at random, keeping only the links the
+// rules allow. Each node is hung off one already placed where possible.
+void PlaceRandomGraph(GameWorld &world, int nodeCount, uint64_t seed);
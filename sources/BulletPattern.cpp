@@ -0,0 +1,119 @@
+#include "BulletPattern.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+struct ShapeName {
+  const char *name;
+  PatternShape shape;
+};
+
+const ShapeName SHAPE_NAMES[] = {
+    {"spread", PatternShape::SPREAD},
+    {"ring", PatternShape::RING},
+    {"spiral", PatternShape::SPIRAL},
+};
+
+bool ParsePatternShape(const std::string &name, PatternShape &shape) {
+  for (const ShapeName &entry : SHAPE_NAMES) {
+    if (name == entry.name) {
+      shape = entry.shape;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+const std::vector<BulletPattern> &GetDefaultBulletPatterns() {
+  static const std::vector<BulletPattern> patterns = {
+      {"aimed", PatternShape::SPREAD, 3, 30.0f, 300.0f, 0.0f, 5},
+      {"burst", PatternShape::RING, 12, 360.0f, 220.0f, 0.0f, 5},
+      {"swirl", PatternShape::SPIRAL, 6, 360.0f, 260.0f, 17.0f, 5},
+  };
+  return patterns;
+}
+
+bool LoadBulletPatterns(const std::string &path,
+                        std::vector<BulletPattern> &patterns) {
+  char *text = LoadFileText(path.c_str());
+  if (!text) {
+    TraceLog(LOG_WARNING, "PATTERNS: could not read %s", path.c_str());
+    return false;
+  }
+
+  patterns.clear();
+  bool valid = true;
+  std::istringstream lines(text);
+  UnloadFileText(text);
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line)) {
+    lineNumber++;
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword[0] == '#')
+      continue;
+
+    if (keyword != "pattern") {
+      TraceLog(LOG_WARNING, "PATTERNS: %s:%d: unknown entry '%s'",
+               path.c_str(), lineNumber, keyword.c_str());
+      valid = false;
+      continue;
+    }
+
+    BulletPattern pattern;
+    std::string shape;
+    if (!(tokens >> pattern.name >> shape >> pattern.count >> pattern.arc >>
+          pattern.speed >> pattern.spin >> pattern.damage) ||
+        !ParsePatternShape(shape, pattern.shape) || pattern.count <= 0 ||
+        pattern.speed <= 0.0f) {
+      TraceLog(LOG_WARNING, "PATTERNS: %s:%d: malformed pattern entry",
+               path.c_str(), lineNumber);
+      valid = false;
+      continue;
+    }
+    patterns.push_back(pattern);
+  }
+  return valid;
+}
+
+Color GetPatternColor(PatternShape shape) {
+  switch (shape) {
+  case PatternShape::SPREAD:
+    return ORANGE;
+  case PatternShape::RING:
+    return PINK;
+  case PatternShape::SPIRAL:
+    return VIOLET;
+  }
+  return RED;
+}
+
+int EmitPattern(const BulletPattern &pattern, float aim, float phase,
+                Vector2 *velocities, int maxCount) {
+  int count = std::min(pattern.count, maxCount);
+  float first = aim;
+  float step = 0.0f;
+  if (pattern.shape == PatternShape::SPREAD) {
+    if (count > 1) {
+      step = pattern.arc * DEG2RAD / (count - 1);
+      first = aim - pattern.arc * DEG2RAD / 2.0f;
+    }
+  } else {
+    step = 2.0f * PI / count;
+    if (pattern.shape == PatternShape::SPIRAL)
+      first = aim + phase * DEG2RAD;
+  }
+
+  for (int i = 0; i < count; i++) {
+    float angle = first + step * i;
+    velocities[i] = {cosf(angle) * pattern.speed,
+                     sinf(angle) * pattern.speed};
+  }
+  return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "raylib.h"
+#include <string>
+#include <vector>
+
+enum class PatternShape { SPREAD, RING, SPIRAL };
+
+// One enemy volley, read from a plain-text file with a line per pattern:
+//
+//   # name  shape   count  arc  speed  spin  damage
+//   pattern aimed   spread 3      30   300    0     5
+//
+// spread fans count bullets over arc degrees centred on the player, ring
+// spaces them evenly around the enemy starting at the player, and spiral
+// is a ring that turns by spin degrees after every volley.
+struct BulletPattern {
+  std::string name;
+  PatternShape shape;
+  int count;
+  float arc;   // Degrees covered by a spread
+  float speed; // Pixels per second
+  float spin;  // Degrees a spiral turns per volley
+  int damage;
+};
+
+// Used when no pattern file is loaded, so headless worlds need no assets
+const std::vector<BulletPattern> &GetDefaultBulletPatterns();
+
+// Returns false when the file can't be read or has malformed entries;
+// patterns is left with the valid ones
+bool LoadBulletPatterns(const std::string &path,
+                        std::vector<BulletPattern> &patterns);
+
+Color GetPatternColor(PatternShape shape);
+
+// Writes the velocity of every bullet in one volley to velocities. aim is
+// the angle to the target in radians; phase is the spiral's current turn
+// in degrees. Returns how many were written, at most maxCount.
+int EmitPattern(const BulletPattern &pattern, float aim, float phase,
+                Vector2 *velocities, int maxCount);
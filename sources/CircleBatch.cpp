@@ -0,0 +1,75 @@
+#include "CircleBatch.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <cmath>
+
+CircleBatch::CircleBatch() : circleTexture{0}, isBatching(false) {}
+
+CircleBatch::~CircleBatch() { Unload(); }
+
+void CircleBatch::Init(int textureSize) {
+  Unload();
+
+  // White disc with a one pixel anti-aliased rim, tinted per quad
+  Image image = GenImageColor(textureSize, textureSize, BLANK);
+  Color *pixels = (Color *)image.data;
+  float radius = textureSize / 2.0f;
+  for (int y = 0; y < textureSize; y++) {
+    for (int x = 0; x < textureSize; x++) {
+      float dx = x + 0.5f - radius;
+      float dy = y + 0.5f - radius;
+      float coverage = fminf(fmaxf(radius - sqrtf(dx * dx + dy * dy), 0.0f),
+                             1.0f);
+      pixels[y * textureSize + x] = {255, 255, 255,
+                                     (unsigned char)(coverage * 255.0f)};
+    }
+  }
+
+  circleTexture = LoadTextureFromImage(image);
+  UnloadImage(image);
+  GenTextureMipmaps(&circleTexture);
+  SetTextureFilter(circleTexture, TEXTURE_FILTER_TRILINEAR);
+}
+
+void CircleBatch::Unload() {
+  if (circleTexture.id != 0) {
+    UnloadTexture(circleTexture);
+    circleTexture = {0};
+  }
+}
+
+void CircleBatch::Begin() {
+  if (!IsLoaded())
+    return;
+  rlSetTexture(circleTexture.id);
+  rlBegin(RL_QUADS);
+  isBatching = true;
+}
+
+void CircleBatch::Add(Vector2 center, float radius, Color color) {
+  if (!isBatching) {
+    DrawCircleV(center, radius, color);
+    return;
+  }
+
+  // Flushes the current batch and keeps drawing if the vertex buffer is full
+  rlCheckRenderBatchLimit(4);
+
+  rlColor4ub(color.r, color.g, color.b, color.a);
+  rlTexCoord2f(0.0f, 0.0f);
+  rlVertex2f(center.x - radius, center.y - radius);
+  rlTexCoord2f(0.0f, 1.0f);
+  rlVertex2f(center.x - radius, center.y + radius);
+  rlTexCoord2f(1.0f, 1.0f);
+  rlVertex2f(center.x + radius, center.y + radius);
+  rlTexCoord2f(1.0f, 0.0f);
+  rlVertex2f(center.x + radius, center.y - radius);
+}
+
+void CircleBatch::End() {
+  if (!isBatching)
+    return;
+  rlEnd();
+  rlSetTexture(0);
+  isBatching = false;
+}
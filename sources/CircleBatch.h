@@ -0,0 +1,31 @@
+#pragma once
+#include "raylib.h"
+
+// Draws filled circles as textured quads that all sample one pre-rasterised
+// circle texture. Everything added between Begin() and End() goes out as a
+// single rlgl draw, instead of one tessellated fan per DrawCircleV call.
+class CircleBatch {
+private:
+  Texture2D circleTexture;
+  bool isBatching;
+
+public:
+  CircleBatch();
+  ~CircleBatch();
+
+  // Disable copy and move operations
+  CircleBatch(const CircleBatch &other) = delete;
+  CircleBatch &operator=(const CircleBatch &other) = delete;
+  CircleBatch(CircleBatch &&other) = delete;
+  CircleBatch &operator=(CircleBatch &&other) = delete;
+
+  // Needs an active GL context
+  void Init(int textureSize = 64);
+  void Unload();
+
+  void Begin();
+  void Add(Vector2 center, float radius, Color color);
+  void End();
+
+  bool IsLoaded() const { return circleTexture.id != 0; }
+};
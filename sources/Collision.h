@@ -0,0 +1,47 @@
+#pragma once
+#include "raylib.h"
+#include <cmath>
+
+// Continuous tests for circles that move in a straight line over a tick.
+// Checking only where things end up lets a bullet step over an enemy once
+// it moves further than their combined diameter in one tick.
+
+// Axis-aligned bounds of a circle's path, for the broadphase
+struct SweptBox {
+  float minX;
+  float minY;
+  float maxX;
+  float maxY;
+};
+
+inline SweptBox MakeSweptBox(Vector2 start, Vector2 end, float radius) {
+  return {fminf(start.x, end.x) - radius, fminf(start.y, end.y) - radius,
+          fmaxf(start.x, end.x) + radius, fmaxf(start.y, end.y) + radius};
+}
+
+inline bool SweptBoxesOverlap(const SweptBox &a, const SweptBox &b) {
+  return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY &&
+         b.minY <= a.maxY;
+}
+
+// Narrowphase: whether two circles moving linearly from their start to
+// their end positions touch at any point in between. In b's frame, a moves
+// along one segment, so this is a segment against a circle of the summed
+// radius.
+inline bool SweptCirclesTouch(Vector2 aStart, Vector2 aEnd, Vector2 bStart,
+                              Vector2 bEnd, float radiusSum) {
+  float startX = aStart.x - bStart.x;
+  float startY = aStart.y - bStart.y;
+  float deltaX = (aEnd.x - bEnd.x) - startX;
+  float deltaY = (aEnd.y - bEnd.y) - startY;
+
+  // Closest point of the relative path to the origin
+  float lengthSqr = deltaX * deltaX + deltaY * deltaY;
+  float t = 0.0f;
+  if (lengthSqr > 0.0f)
+    t = fminf(1.0f,
+              fmaxf(0.0f, -(startX * deltaX + startY * deltaY) / lengthSqr));
+  float closestX = startX + deltaX * t;
+  float closestY = startY + deltaY * t;
+  return closestX * closestX + closestY * closestY <= radiusSum * radiusSum;
+}
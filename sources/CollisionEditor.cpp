@@ -9,21 +9,11 @@ CollisionEditor::CollisionEditor()
       currentEditMode(EditMode::MOVE), dragStartPos{0, 0},
       originalRect{0, 0, 0, 0} {}
 
-CollisionEditor::~CollisionEditor() {
-  // Note: If textures were loaded by this class, we'd unload them here
-  // But since they might be managed elsewhere, we don't unload
-}
+CollisionEditor::~CollisionEditor() {}
 
 void CollisionEditor::AddSprite(const std::string &name,
-                                const std::string &texturePath) {
-  Texture2D texture = LoadTexture(texturePath.c_str());
-  if (texture.id != 0) {
-    sprites.emplace_back(name, texture);
-  }
-}
-
-void CollisionEditor::AddSprite(const std::string &name, Texture2D texture) {
-  if (texture.id != 0) {
+                                TextureHandle texture) {
+  if (texture.IsValid()) {
     sprites.emplace_back(name, texture);
   }
 }
@@ -165,10 +155,11 @@ void CollisionEditor::UpdateCollisionRect(Vector2 currentMousePos) {
     newRect.height += newRect.y;
     newRect.y = 0;
   }
-  if (newRect.x + newRect.width > sprite.sprite.width)
-    newRect.width = sprite.sprite.width - newRect.x;
-  if (newRect.y + newRect.height > sprite.sprite.height)
-    newRect.height = sprite.sprite.height - newRect.y;
+  const Texture2D &texture = sprite.sprite.Get();
+  if (newRect.x + newRect.width > texture.width)
+    newRect.width = texture.width - newRect.x;
+  if (newRect.y + newRect.height > texture.height)
+    newRect.height = texture.height - newRect.y;
 
   sprite.collisionRect = newRect;
 }
@@ -223,8 +214,9 @@ void CollisionEditor::Update() {
   // Reset collision rect with R key
   if (IsKeyPressed(KEY_R)) {
     auto &sprite = sprites[selectedSpriteIndex];
-    sprite.collisionRect = {0, 0, static_cast<float>(sprite.sprite.width),
-                            static_cast<float>(sprite.sprite.height)};
+    const Texture2D &texture = sprite.sprite.Get();
+    sprite.collisionRect = {0, 0, static_cast<float>(texture.width),
+                            static_cast<float>(texture.height)};
   }
 }
 
@@ -266,9 +258,9 @@ void CollisionEditor::DrawUI() const {
   // Current sprite info
   if (selectedSpriteIndex >= 0 && selectedSpriteIndex < sprites.size()) {
     const auto &sprite = sprites[selectedSpriteIndex];
-    std::string info = "Selected: " + sprite.name + " (" +
-                       std::to_string(selectedSpriteIndex + 1) + ")";
-    DrawText(info.c_str(), 10, 110, 18, YELLOW);
+    DrawText(TextFormat("Selected: %s (%d)", sprite.name.c_str(),
+                        selectedSpriteIndex + 1),
+             10, 110, 18, YELLOW);
 
     // Collision rect info
     char rectInfo[256];
@@ -282,8 +274,8 @@ void CollisionEditor::DrawUI() const {
   int yOffset = 160;
   for (size_t i = 0; i < sprites.size(); i++) {
     Color textColor = (i == selectedSpriteIndex) ? YELLOW : LIGHTGRAY;
-    std::string spriteInfo = std::to_string(i + 1) + ": " + sprites[i].name;
-    DrawText(spriteInfo.c_str(), 10, yOffset, 14, textColor);
+    DrawText(TextFormat("%d: %s", (int)(i + 1), sprites[i].name.c_str()), 10,
+             yOffset, 14, textColor);
     yOffset += 20;
   }
 }
@@ -299,13 +291,14 @@ void CollisionEditor::Draw() const {
   for (size_t i = 0; i < sprites.size(); i++) {
     const auto &sprite = sprites[i];
 
-    // Draw sprite
+    // Draw sprite, the placeholder until it has loaded
+    const Texture2D &texture = sprite.sprite.Get();
     Rectangle destRect = {sprite.spritePosition.x, sprite.spritePosition.y,
-                          sprite.sprite.width * sprite.spriteScale,
-                          sprite.sprite.height * sprite.spriteScale};
-    DrawTexturePro(sprite.sprite,
-                   {0, 0, static_cast<float>(sprite.sprite.width),
-                    static_cast<float>(sprite.sprite.height)},
+                          texture.width * sprite.spriteScale,
+                          texture.height * sprite.spriteScale};
+    DrawTexturePro(texture,
+                   {0, 0, static_cast<float>(texture.width),
+                    static_cast<float>(texture.height)},
                    destRect, {0, 0}, 0, WHITE);
 
     // Draw collision rectangle
@@ -341,6 +334,16 @@ Rectangle CollisionEditor::GetCollisionRect(const std::string &name) const {
 }
 
 void CollisionEditor::Step() {
+  // Default collision rect to full sprite size once the texture is in
+  for (auto &sprite : sprites) {
+    if (!sprite.hasCollisionRect && sprite.sprite.IsReady()) {
+      const Texture2D &texture = sprite.sprite.Get();
+      sprite.collisionRect = {0, 0, static_cast<float>(texture.width),
+                              static_cast<float>(texture.height)};
+      sprite.hasCollisionRect = true;
+    }
+  }
+
   // Toggle editor with F1
   if (IsKeyPressed(KEY_F1)) {
     Toggle();
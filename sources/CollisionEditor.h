@@ -1,4 +1,5 @@
 #pragma once
+#include "ResourceCache.h"
 #include "raylib.h"
 #include <string>
 #include <vector>
@@ -17,17 +18,16 @@ enum class EditMode {
 
 struct SpriteCollider {
   std::string name;
-  Texture2D sprite;
+  TextureHandle sprite;
   Rectangle collisionRect;
+  bool hasCollisionRect; // Set once the texture has loaded
   Vector2 spritePosition;
   float spriteScale;
 
-  SpriteCollider(const std::string &spriteName, Texture2D spriteTexture)
-      : name(spriteName), sprite(spriteTexture), spriteScale(2.0f) {
+  SpriteCollider(const std::string &spriteName, TextureHandle spriteTexture)
+      : name(spriteName), sprite(spriteTexture), collisionRect{0, 0, 0, 0},
+        hasCollisionRect(false), spriteScale(2.0f) {
     spritePosition = {400, 300}; // Center of screen roughly
-    // Default collision rect to full sprite size
-    collisionRect = {0, 0, static_cast<float>(sprite.width),
-                     static_cast<float>(sprite.height)};
   }
 };
 
@@ -60,8 +60,8 @@ public:
   ~CollisionEditor();
 
   // Main interface
-  void AddSprite(const std::string &name, const std::string &texturePath);
-  void AddSprite(const std::string &name, Texture2D texture);
+  // The editor shares the texture; it is released with the last handle
+  void AddSprite(const std::string &name, TextureHandle texture);
   void Toggle() { isActive = !isActive; }
   bool IsActive() const { return isActive; }
 
@@ -16,11 +16,14 @@ const Color STAT_ACTION_LINK_COLOR = {128, 0, 128, 255};
 const Color POWER_LINK_COLOR = {50, 205, 50, 255};
 const Color CYAN = {0, 255, 255, 255};
 
-ControlPanel::ControlPanel(Player &player, SpriteManager &spriteManager)
+ControlPanel::ControlPanel(Player &player, SpriteManager &spriteManager,
+                           NodesController &nodesController,
+                           FrameArena &frameArena)
     : isPanelOpen(false), inventoryScrollOffset(0.0f), draggingNodeIndex(-1),
       draggingFromInventory(false), connectingNodeFromId(-1),
-      startCameraDraggingPos({-1, -1}), player(player),
-      spriteManager(spriteManager) {}
+      startCameraDraggingPos({-1, -1}), player(player), snapshot(nullptr),
+      estimate(), estimateKey(0), spriteManager(spriteManager),
+      nodesController(nodesController), frameArena(frameArena) {}
 
 void ControlPanel::Initialize(int screenWidth, int screenHeight) {
   panelArea = {screenWidth * 2.0f / 3.0f, 0, screenWidth / 3.0f,
@@ -38,17 +41,29 @@ void ControlPanel::Initialize(int screenWidth, int screenHeight) {
                         panelGridArea.y + panelGridArea.height / 2.0f};
   panelCamera.rotation = 0.0f;
   panelCamera.zoom = 1.0f;
+
+  frameWidget.rect = panelArea;
+  inventoryWidget.rect = panelInventoryArea;
+  gridWidget.rect = panelGridArea;
+  layer.Layout(screenWidth, screenHeight);
 }
 
-void ControlPanel::Update(Player &player, float dt) {
+void ControlPanel::Update(const RenderSnapshot &snapshot, float dt) {
   if (!isPanelOpen)
     return;
+  this->snapshot = &snapshot;
 
   UpdateInventoryScroll();
   UpdateGridCamera();
   HandleCameraMove();
   UpdateNodeDragging();
   UpdateNodeConnections();
+
+  uint64_t graphKey = GetGraphKey();
+  if (graphKey != estimateKey) {
+    estimate = AnalyzeBuild(player, nodesController);
+    estimateKey = graphKey;
+  }
 }
 
 void ControlPanel::UpdateInventoryScroll() {
@@ -56,7 +71,7 @@ void ControlPanel::UpdateInventoryScroll() {
   if (CheckCollisionPointRec(mousePosScreen, panelInventoryArea)) {
     inventoryScrollOffset -= GetMouseWheelMove() * NODE_INV_ITEM_HEIGHT * 0.5f;
     float maxScroll =
-        fmaxf(0.0f, (player.inventoryNodes.size() * NODE_INV_ITEM_HEIGHT) -
+        fmaxf(0.0f, (GetInventoryRowCount() * NODE_INV_ITEM_HEIGHT) -
                         panelInventoryArea.height);
     inventoryScrollOffset = Clamp(inventoryScrollOffset, 0.0f, maxScroll);
   }
@@ -124,17 +139,10 @@ void ControlPanel::UpdateNodeDragging() {
 
       // Check inventory area for dragging
       if (CheckCollisionPointRec(mousePosScreen, panelInventoryArea)) {
-        for (size_t i = 0; i < player.inventoryNodes.size(); ++i) {
-          Rectangle nodeRect = {panelInventoryArea.x + 5,
-                                panelInventoryArea.y + 5 +
-                                    i * NODE_INV_ITEM_HEIGHT -
-                                    inventoryScrollOffset,
-                                panelInventoryArea.width - 10, NODE_UI_SIZE};
-          if (CheckCollisionPointRec(mousePosScreen, nodeRect)) {
-            draggingNodeIndex = (int)i;
-            draggingFromInventory = true;
-            break;
-          }
+        int row = GetInventoryRowAt(mousePosScreen);
+        if (row != -1) {
+          draggingNodeIndex = row;
+          draggingFromInventory = true;
         }
       }
 
@@ -203,129 +211,9 @@ void ControlPanel::UpdateNodeConnections() {
 
   // Complete connection on right-click release
   if (IsMouseButtonReleased(MOUSE_RIGHT_BUTTON)) {
-    if (connectingNodeFromId != -1 && toNodeForConnection) {
-      BaseNode *fromNode = player.GetPlayerNodeById(connectingNodeFromId);
-      if (fromNode && fromNode->id != toNodeForConnection->id) {
-        bool connectionChanged = false;
-
-        // CPU Core connection rules
-        if (fromNode->getNodeType() == NodeType::CPU_CORE) {
-          if (toNodeForConnection->getNodeKind() == NodeKind::STAT ||
-              toNodeForConnection->getNodeKind() == NodeKind::POWER ||
-              toNodeForConnection->getNodeKind() == NodeKind::ACTION) {
-
-            // Special rule: CPU can only connect to one ACTION at a time
-            if (toNodeForConnection->getNodeKind() == NodeKind::ACTION) {
-              // Remove existing ACTION connections
-              for (size_t i = 0; i < fromNode->connectedToNodeIDs.size();) {
-                BaseNode *existingTarget =
-                    player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
-                if (existingTarget &&
-                    existingTarget->getNodeKind() == NodeKind::ACTION &&
-                    existingTarget->id != toNodeForConnection->id) {
-                  // Remove bidirectional connection
-                  existingTarget->connectedFromNodeIDs.erase(
-                      std::remove(existingTarget->connectedFromNodeIDs.begin(),
-                                  existingTarget->connectedFromNodeIDs.end(),
-                                  fromNode->id),
-                      existingTarget->connectedFromNodeIDs.end());
-                  fromNode->connectedToNodeIDs.erase(
-                      fromNode->connectedToNodeIDs.begin() + i);
-                  connectionChanged = true;
-                } else {
-                  i++;
-                }
-              }
-            }
-
-            // Add new connection if not already connected
-            if (std::find(fromNode->connectedToNodeIDs.begin(),
-                          fromNode->connectedToNodeIDs.end(),
-                          toNodeForConnection->id) ==
-                fromNode->connectedToNodeIDs.end()) {
-              fromNode->connectedToNodeIDs.push_back(toNodeForConnection->id);
-              toNodeForConnection->connectedFromNodeIDs.push_back(fromNode->id);
-              connectionChanged = true;
-            }
-          }
-        }
-        // ACTION to ACTION sequence connections
-        else if (fromNode->getNodeKind() == NodeKind::ACTION &&
-                 toNodeForConnection->getNodeKind() == NodeKind::ACTION) {
-          // Remove existing ACTION connections from this node
-          for (size_t i = 0; i < fromNode->connectedToNodeIDs.size();) {
-            BaseNode *existingTarget =
-                player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
-            if (existingTarget &&
-                existingTarget->getNodeKind() == NodeKind::ACTION &&
-                existingTarget->id != toNodeForConnection->id) {
-              existingTarget->connectedFromNodeIDs.erase(
-                  std::remove(existingTarget->connectedFromNodeIDs.begin(),
-                              existingTarget->connectedFromNodeIDs.end(),
-                              fromNode->id),
-                  existingTarget->connectedFromNodeIDs.end());
-              fromNode->connectedToNodeIDs.erase(
-                  fromNode->connectedToNodeIDs.begin() + i);
-              connectionChanged = true;
-            } else {
-              i++;
-            }
-          }
-
-          // Add new connection
-          if (std::find(fromNode->connectedToNodeIDs.begin(),
-                        fromNode->connectedToNodeIDs.end(),
-                        toNodeForConnection->id) ==
-              fromNode->connectedToNodeIDs.end()) {
-            fromNode->connectedToNodeIDs.push_back(toNodeForConnection->id);
-            toNodeForConnection->connectedFromNodeIDs.push_back(fromNode->id);
-            connectionChanged = true;
-          }
-        }
-        // STAT to ACTION buff connections
-        else if (fromNode->getNodeKind() == NodeKind::STAT &&
-                 toNodeForConnection->getNodeKind() == NodeKind::ACTION) {
-          if (std::find(fromNode->connectedToNodeIDs.begin(),
-                        fromNode->connectedToNodeIDs.end(),
-                        toNodeForConnection->id) ==
-              fromNode->connectedToNodeIDs.end()) {
-            fromNode->connectedToNodeIDs.push_back(toNodeForConnection->id);
-            toNodeForConnection->connectedFromNodeIDs.push_back(fromNode->id);
-            connectionChanged = true;
-          }
-        }
-        // POWER to STAT/ACTION modifier connections
-        else if (fromNode->getNodeKind() == NodeKind::POWER &&
-                 (toNodeForConnection->getNodeKind() == NodeKind::ACTION ||
-                  toNodeForConnection->getNodeKind() == NodeKind::STAT)) {
-          // Remove existing POWER connections (POWER nodes can only connect to
-          // one target)
-          for (size_t i = 0; i < fromNode->connectedToNodeIDs.size(); i++) {
-            BaseNode *existingTarget =
-                player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
-            if (existingTarget) {
-              existingTarget->connectedFromNodeIDs.erase(
-                  std::remove(existingTarget->connectedFromNodeIDs.begin(),
-                              existingTarget->connectedFromNodeIDs.end(),
-                              fromNode->id),
-                  existingTarget->connectedFromNodeIDs.end());
-            }
-          }
-          fromNode->connectedToNodeIDs.clear();
-
-          // Add new connection
-          fromNode->connectedToNodeIDs.push_back(toNodeForConnection->id);
-          toNodeForConnection->connectedFromNodeIDs.push_back(fromNode->id);
-          connectionChanged = true;
-        }
-
-        // Update node activations if connections changed
-        if (connectionChanged) {
-          // Reset active action to restart sequences
-          player.activeActionNodeId = -1;
-        }
-      }
-    }
+    if (connectingNodeFromId != -1 && toNodeForConnection)
+      nodesController.ConnectNodes(player, connectingNodeFromId,
+                                   toNodeForConnection->id);
     connectingNodeFromId = -1;
   }
 }
@@ -334,19 +222,19 @@ void ControlPanel::HandleNodePlacement() {
   Vector2 mousePosScreen = GetMousePosition();
   if (CheckCollisionPointRec(mousePosScreen, panelGridArea) &&
       draggingNodeIndex >= 0 &&
-      draggingNodeIndex < (int)player.inventoryNodes.size()) {
+      draggingNodeIndex < (int)player.inventoryStacks.size()) {
     Vector2 mousePosPanelGridWorld =
         GetScreenToWorld2D(mousePosScreen, panelCamera);
 
-    // Move node from inventory to placed nodes
-    auto nodeToPlace = std::move(player.inventoryNodes[draggingNodeIndex]);
+    // Materialise one node from the stack and place it on the grid
+    auto nodeToPlace = nodesController.CreateNodeFromTemplate(
+        player.inventoryStacks[draggingNodeIndex].type);
     nodeToPlace->isPlaced = true;
     nodeToPlace->panelPosition = mousePosPanelGridWorld;
 
     // Add to placed nodes and remove from inventory
     player.placedNodes.push_back(std::move(nodeToPlace));
-    player.inventoryNodes.erase(player.inventoryNodes.begin() +
-                                draggingNodeIndex);
+    player.TakeInventoryNode(draggingNodeIndex);
 
     // Update node activations after placement
     // We'll need to call the NodesController's UpdateNodeActivation
@@ -398,67 +286,184 @@ void ControlPanel::HandleNodeRemoval() {
       }
     }
 
-    // Add to inventory and remove from placed nodes
-    player.inventoryNodes.push_back(std::move(nodeToRemove));
+    // Return to its inventory stack and drop the instance
+    player.AddInventoryNode(nodeToRemove->getNodeType());
     player.placedNodes.erase(player.placedNodes.begin() + draggingNodeIndex);
 
     // Reset active action if it was this node
-    if (removedNodeId == player.activeActionNodeId) {
-      player.activeActionNodeId = -1;
-      player.playerShieldIsActive = false;
-    }
+    if (removedNodeId == player.activeActionNodeId)
+      nodesController.CancelAction(player);
 
     // Update node activations after removal
     // We'll need to call the NodesController's UpdateNodeActivation
   }
 }
 
-void ControlPanel::Draw(const Player &player) {
+Rectangle ControlPanel::GetInventoryRowRect(int row) const {
+  return {panelInventoryArea.x + 5,
+          panelInventoryArea.y + 5 + row * NODE_INV_ITEM_HEIGHT -
+              inventoryScrollOffset,
+          panelInventoryArea.width - 10, NODE_UI_SIZE};
+}
+
+int ControlPanel::GetInventoryRowAt(Vector2 mousePos) const {
+  float contentY = mousePos.y - (panelInventoryArea.y + 5) +
+                   inventoryScrollOffset;
+  if (contentY < 0)
+    return -1;
+  int row = (int)(contentY / NODE_INV_ITEM_HEIGHT);
+  if (row >= GetInventoryRowCount())
+    return -1;
+  // Rows are separated by a gap, so the slot may still miss the row itself
+  return CheckCollisionPointRec(mousePos, GetInventoryRowRect(row)) ? row : -1;
+}
+
+void ControlPanel::GetVisibleInventoryRows(int &first, int &last) const {
+  int rowCount = GetInventoryRowCount();
+  first = (int)floorf((inventoryScrollOffset - 5 - NODE_UI_SIZE) /
+                      NODE_INV_ITEM_HEIGHT) +
+          1;
+  last = (int)ceilf((inventoryScrollOffset + panelInventoryArea.height - 5) /
+                    NODE_INV_ITEM_HEIGHT);
+  first = std::max(0, first);
+  last = std::min(rowCount, last);
+}
+
+int ControlPanel::GetInventoryRowCount() const {
+  // Rows only ever get appended by the simulation, so the snapshot's rows
+  // are a prefix of the live inventory
+  return snapshot ? snapshot->inventoryCount : 0;
+}
+
+uint64_t ControlPanel::GetGraphKey() const {
+  UiKey key;
+  for (const auto &node : player.placedNodes) {
+    key.Add(node->id)
+        .Add((int)node->getNodeType())
+        .Add((int)node->isActive)
+        .Add(node->value)
+        .Add(node->duration)
+        .Add((int)node->connectedToNodeIDs.size());
+    for (int targetId : node->connectedToNodeIDs)
+      key.Add(targetId);
+  }
+  return key.Get();
+}
+
+uint64_t ControlPanel::GetInventoryKey() const {
+  UiKey key;
+  int firstRow, lastRow;
+  GetVisibleInventoryRows(firstRow, lastRow);
+  key.Add(inventoryScrollOffset)
+      .Add(GetInventoryRowCount())
+      .Add(GetInventoryRowAt(GetMousePosition()));
+  for (int i = firstRow; i < lastRow; ++i)
+    key.Add((int)snapshot->inventory[i].type).Add(snapshot->inventory[i].count);
+  return key.Get();
+}
+
+uint64_t ControlPanel::GetGridKey() const {
+  UiKey key;
+  key.Add(GetGraphKey())
+      .Add(panelCamera.target)
+      .Add(panelCamera.offset)
+      .Add(panelCamera.zoom)
+      .Add(snapshot->activeActionNodeId)
+      .Add((int)snapshot->activeActionIsEffect);
+  for (const auto &node : player.placedNodes)
+    key.Add(node->panelPosition);
+  // A running effect pulses its node, so the grid repaints every frame
+  if (snapshot->activeActionNodeId != -1 && snapshot->activeActionIsEffect)
+    key.Add((float)GetTime());
+  return key.Get();
+}
+
+bool ControlPanel::WillEditGraph() const {
+  // Placement, removal and linking all complete on a button release. A press
+  // and release can land in the same frame, so don't rely on drag state.
+  return isPanelOpen && (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) ||
+                         IsMouseButtonReleased(MOUSE_RIGHT_BUTTON));
+}
+
+void ControlPanel::Paint(const RenderSnapshot &snapshot) {
+  if (!isPanelOpen)
+    return;
+  this->snapshot = &snapshot;
+
+  // The frame lies under the other widgets, so it must go first; its key
+  // never changes, so it only repaints after a layout, along with them
+  if (layer.BeginRepaint(frameWidget, 0)) {
+    DrawFrame();
+    layer.EndRepaint();
+  }
+  if (layer.BeginRepaint(inventoryWidget, GetInventoryKey())) {
+    DrawInventoryArea();
+    layer.EndRepaint();
+  }
+  if (layer.BeginRepaint(gridWidget, GetGridKey())) {
+    DrawGridArea();
+    layer.EndRepaint();
+  }
+}
+
+void ControlPanel::Draw(const RenderSnapshot &snapshot) {
   if (!isPanelOpen)
     return;
+  this->snapshot = &snapshot;
+
+  layer.Draw(panelArea);
+  DrawInventoryHover();
+  DrawConnectionPreview();
+  DrawDraggedNode();
+  DrawTooltips();
+}
 
-  DrawRectangleRec(panelArea, ColorAlpha(BLACK, 0.85f));
+void ControlPanel::DrawBackdrop(Rectangle area) {
+  DrawRectangleRec(area, ColorAlpha(BLACK, 0.85f));
+}
+
+void ControlPanel::DrawFrame() {
+  DrawBackdrop(panelArea);
   DrawRectangleLinesEx(panelArea, 1, DARKGRAY);
   DrawText("CONTROL PANEL (TAB)", (int)(panelArea.x + 10),
            (int)(panelArea.y + 10), 20, WHITE);
-
-  DrawInventoryArea();
-  DrawGridArea();
+  DrawText("Inventory:", (int)panelInventoryArea.x,
+           (int)(panelInventoryArea.y - 25), 15, WHITE);
+  DrawText("System Grid:", (int)panelGridArea.x, (int)(panelGridArea.y - 25),
+           15, WHITE);
 }
 
 void ControlPanel::DrawInventoryArea() {
-  DrawText("Inventory:", (int)panelInventoryArea.x,
-           (int)(panelInventoryArea.y - 25), 15, WHITE);
+  DrawBackdrop(panelInventoryArea);
   DrawRectangleRec(panelInventoryArea, ColorAlpha(DARKSLATEBLUE, 0.5f));
 
   BeginScissorMode((int)panelInventoryArea.x, (int)panelInventoryArea.y,
                    (int)panelInventoryArea.width,
                    (int)panelInventoryArea.height);
 
-  // Draw inventory nodes - add safety check
-  if (!player.inventoryNodes.empty()) {
-    for (size_t i = 0; i < player.inventoryNodes.size(); ++i) {
-      if (!player.inventoryNodes[i])
-        continue; // Safety check for null pointers
-
-      Rectangle nodeRect = {panelInventoryArea.x + 5,
-                            panelInventoryArea.y + 5 +
-                                i * NODE_INV_ITEM_HEIGHT -
-                                inventoryScrollOffset,
-                            panelInventoryArea.width - 10, NODE_UI_SIZE};
-      if (nodeRect.y + nodeRect.height > panelInventoryArea.y &&
-          nodeRect.y < panelInventoryArea.y + panelInventoryArea.height) {
-        bool isHovered = CheckCollisionPointRec(GetMousePosition(), nodeRect);
-        DrawRectangleRec(nodeRect, player.inventoryNodes[i]->color);
-        player.inventoryNodes[i]->Draw(spriteManager, nodeRect, 0);
-        DrawRectangleLinesEx(nodeRect, 2, isHovered ? YELLOW : DARKGRAY);
-        DrawText(player.inventoryNodes[i]->name.c_str(), (int)(nodeRect.x + 5),
-                 (int)(nodeRect.y + 5), 10, BLACK);
-        if (isHovered)
-          DrawText(player.inventoryNodes[i]->description.c_str(),
-                   (int)(GetMousePosition().x + 15),
-                   (int)(GetMousePosition().y + 5), 10, WHITE);
-      }
+  // Only the rows inside the viewport are visited
+  int firstRow, lastRow;
+  GetVisibleInventoryRows(firstRow, lastRow);
+  int hoveredRow = GetInventoryRowAt(GetMousePosition());
+  for (int i = firstRow; i < lastRow; ++i) {
+    const InventoryStack &stack = snapshot->inventory[i];
+    BaseNode *templateNode = nodesController.GetTemplate(stack.type);
+    if (!templateNode)
+      continue;
+
+    Rectangle nodeRect = GetInventoryRowRect(i);
+    bool isHovered = i == hoveredRow;
+    DrawRectangleRec(nodeRect, templateNode->color);
+    templateNode->Draw(spriteManager, nodeRect, 0);
+    DrawRectangleLinesEx(nodeRect, 2, isHovered ? YELLOW : DARKGRAY);
+    DrawText(templateNode->name.c_str(), (int)(nodeRect.x + 5),
+             (int)(nodeRect.y + 5), 10, BLACK);
+    if (stack.count > 1) {
+      const char *countText = TextFormat("x%d", stack.count);
+      DrawText(countText,
+               (int)(nodeRect.x + nodeRect.width - MeasureText(countText, 10) -
+                     5),
+               (int)(nodeRect.y + 5), 10, BLACK);
     }
   }
 
@@ -467,9 +472,26 @@ void ControlPanel::DrawInventoryArea() {
   DrawScrollbar();
 }
 
+void ControlPanel::DrawInventoryHover() {
+  Vector2 mousePos = GetMousePosition();
+  int row = GetInventoryRowAt(mousePos);
+  if (row == -1)
+    return;
+  const BaseNode *templateNode =
+      nodesController.GetTemplate(snapshot->inventory[row].type);
+  if (!templateNode)
+    return;
+
+  BeginScissorMode((int)panelInventoryArea.x, (int)panelInventoryArea.y,
+                   (int)panelInventoryArea.width,
+                   (int)panelInventoryArea.height);
+  DrawText(templateNode->description.c_str(), (int)(mousePos.x + 15),
+           (int)(mousePos.y + 5), 10, WHITE);
+  EndScissorMode();
+}
+
 void ControlPanel::DrawGridArea() {
-  DrawText("System Grid:", (int)panelGridArea.x, (int)(panelGridArea.y - 25),
-           15, WHITE);
+  DrawBackdrop(panelGridArea);
   DrawRectangleRec(panelGridArea, ColorAlpha(MIDNIGHTBLUE, 0.5f));
 
   BeginScissorMode((int)panelGridArea.x, (int)panelGridArea.y,
@@ -482,18 +504,47 @@ void ControlPanel::DrawGridArea() {
   EndMode2D();
   EndScissorMode();
 
-  DrawDraggedNode();
-  DrawTooltips();
+  DrawEstimate();
+}
+
+void ControlPanel::DrawEstimate() {
+  int x = (int)panelGridArea.x + 5;
+  int y = (int)(panelGridArea.y + panelGridArea.height) - 40;
+  DrawText(TextFormat("Build DPS: %.1f blasts + %.1f manual",
+                      estimate.actionDps, estimate.manualDps),
+           x, y, 10, LIGHTGRAY);
+  // TextFormat cycles through several buffers, so the two calls can nest
+  const char *health = std::isinf(estimate.effectiveHealth)
+                           ? "unlimited"
+                           : TextFormat("%.0f", estimate.effectiveHealth);
+  DrawText(TextFormat("Shield %d%%  Speed %.0f  EHP %s",
+                      (int)(estimate.shieldUptime * 100.0f + 0.5f),
+                      estimate.averageSpeed, health),
+           x, y + 14, 10, LIGHTGRAY);
 }
 
 void ControlPanel::DrawConnections() {
+  // Links name their target by id, so index the placed nodes once instead
+  // of searching them for every link
+  int maxId = -1;
+  for (const auto &node : player.placedNodes)
+    if (node)
+      maxId = std::max(maxId, node->id);
+  FrameVector<const BaseNode *> nodesById(
+      maxId + 1, nullptr, FrameAllocator<const BaseNode *>(frameArena));
+  for (const auto &node : player.placedNodes)
+    if (node)
+      nodesById[node->id] = node.get();
+
   // Draw connections between nodes
   for (const auto &fromNode : player.placedNodes) {
     if (!fromNode)
       continue;
 
     for (int targetNodeId : fromNode->connectedToNodeIDs) {
-      const BaseNode *toNode = player.GetPlayerNodeById(targetNodeId);
+      const BaseNode *toNode = targetNodeId >= 0 && targetNodeId <= maxId
+                                   ? nodesById[targetNodeId]
+                                   : nullptr;
       if (toNode) {
         Color lineColor = GRAY;
         bool isDirected = false;
@@ -550,24 +601,33 @@ void ControlPanel::DrawConnections() {
     }
   }
 
-  // Draw connection preview line while connecting
-  if (connectingNodeFromId != -1) {
-    const BaseNode *fromNode = player.GetPlayerNodeById(connectingNodeFromId);
-    if (fromNode) {
-      DrawLineEx(fromNode->panelPosition,
-                 GetScreenToWorld2D(GetMousePosition(), panelCamera),
-                 fmaxf(1.0f, 2.0f / panelCamera.zoom), LIGHTGRAY);
-    }
-  }
+}
+
+void ControlPanel::DrawConnectionPreview() {
+  if (connectingNodeFromId == -1)
+    return;
+  const BaseNode *fromNode = player.GetPlayerNodeById(connectingNodeFromId);
+  if (!fromNode)
+    return;
+
+  BeginScissorMode((int)panelGridArea.x, (int)panelGridArea.y,
+                   (int)panelGridArea.width, (int)panelGridArea.height);
+  BeginMode2D(panelCamera);
+  DrawLineEx(fromNode->panelPosition,
+             GetScreenToWorld2D(GetMousePosition(), panelCamera),
+             fmaxf(1.0f, 2.0f / panelCamera.zoom), LIGHTGRAY);
+  EndMode2D();
+  EndScissorMode();
 }
 
 void ControlPanel::DrawNodes() {
   for (const auto &node : player.placedNodes) {
     if (!node)
       continue; // Safety check for null pointers
+    bool isActiveAction = node->id == snapshot->activeActionNodeId;
+    bool isActiveEffect = isActiveAction && snapshot->activeActionIsEffect;
     Color nodeDrawColor = node->color;
-    if (node->id == player.activeActionNodeId &&
-        node->isCurrentlyActiveEffect) {
+    if (isActiveEffect) {
       float pulse = (sinf(GetTime() * 5.0f) + 1.0f) / 2.0f;
       nodeDrawColor.r =
           (unsigned char)Clamp(node->color.r + pulse * 50, 0, 255);
@@ -583,12 +643,9 @@ void ControlPanel::DrawNodes() {
                            node->getNodeKind() == NodeKind::POWER ||
                            node->getNodeType() == NodeType::CPU_CORE))
       borderColor = YELLOW;
-    else if (node->id == player.activeActionNodeId &&
-             node->isCurrentlyActiveEffect)
+    else if (isActiveEffect)
       borderColor = WHITE;
-    else if (node->getNodeKind() == NodeKind::ACTION &&
-             !node->isCurrentlyActiveEffect &&
-             player.activeActionNodeId == node->id)
+    else if (node->getNodeKind() == NodeKind::ACTION && isActiveAction)
       borderColor = LIGHTGRAY;
 
     DrawCircleLines((int)node->panelPosition.x, (int)node->panelPosition.y,
@@ -606,8 +663,9 @@ void ControlPanel::DrawNodes() {
 
 void ControlPanel::DrawDraggedNode() {
   if (draggingNodeIndex != -1 && draggingFromInventory &&
-      draggingNodeIndex < (int)player.inventoryNodes.size()) {
-    const auto &node = player.inventoryNodes[draggingNodeIndex];
+      draggingNodeIndex < GetInventoryRowCount()) {
+    const BaseNode *node = nodesController.GetTemplate(
+        snapshot->inventory[draggingNodeIndex].type);
     if (node) {
       DrawCircleV(GetMousePosition(), NODE_UI_SIZE / 2.0f,
                   ColorAlpha(node->color, 0.7f));
@@ -633,38 +691,42 @@ void ControlPanel::DrawTooltips() {
         Vector2 tooltipPos = {mousePosScreen.x + 10,
                               mousePosScreen.y + yOff - 2};
 
-        std::string descText = node->description;
-        std::string line2Text =
+        // TextFormat cycles through several buffers, so both lines stay
+        // valid until they are drawn and nothing needs copying
+        const char *descText = node->description.c_str();
+        const char *line2Text =
             TextFormat("ID:%d Val:%.1f", node->id, node->value);
-        std::string line3Text;
+        const char *line3Text = nullptr;
 
         if (node->getNodeKind() == NodeKind::ACTION) {
+          bool isActiveEffect = node->id == snapshot->activeActionNodeId &&
+                                snapshot->activeActionIsEffect;
           line3Text = TextFormat("Dur:%.1fs Eff:%s", node->duration,
-                                 node->isCurrentlyActiveEffect ? "ON" : "OFF");
+                                 isActiveEffect ? "ON" : "OFF");
         } else if (node->getNodeKind() == NodeKind::STAT ||
                    node->getNodeKind() == NodeKind::POWER) {
           line3Text = TextFormat("Active:%s", node->isActive ? "YES" : "NO");
         }
 
         float maxWidth = 0;
-        maxWidth = fmaxf(maxWidth, (float)MeasureText(descText.c_str(), 10));
-        maxWidth = fmaxf(maxWidth, (float)MeasureText(line2Text.c_str(), 10));
-        if (!line3Text.empty())
-          maxWidth = fmaxf(maxWidth, (float)MeasureText(line3Text.c_str(), 10));
+        maxWidth = fmaxf(maxWidth, (float)MeasureText(descText, 10));
+        maxWidth = fmaxf(maxWidth, (float)MeasureText(line2Text, 10));
+        if (line3Text)
+          maxWidth = fmaxf(maxWidth, (float)MeasureText(line3Text, 10));
         maxWidth = fmaxf(120.0f, maxWidth + 10); // Min width + Padding
 
-        float tooltipHeight = 12 + (line3Text.empty() ? 0 : 12) + 12 + 4;
+        float tooltipHeight = 12 + (line3Text ? 12 : 0) + 12 + 4;
 
         DrawRectangle((int)tooltipPos.x, (int)tooltipPos.y, (int)maxWidth,
                       (int)tooltipHeight, ColorAlpha(BLACK, 0.8f));
-        DrawText(descText.c_str(), (int)(tooltipPos.x + 5),
-                 (int)(tooltipPos.y + 2), 10, WHITE);
+        DrawText(descText, (int)(tooltipPos.x + 5), (int)(tooltipPos.y + 2),
+                 10, WHITE);
         yOff += 12;
-        DrawText(line2Text.c_str(), (int)(tooltipPos.x + 5),
+        DrawText(line2Text, (int)(tooltipPos.x + 5),
                  (int)(tooltipPos.y + yOff - 3 + 2), 10, WHITE);
         yOff += 12;
-        if (!line3Text.empty())
-          DrawText(line3Text.c_str(), (int)(tooltipPos.x + 5),
+        if (line3Text)
+          DrawText(line3Text, (int)(tooltipPos.x + 5),
                    (int)(tooltipPos.y + yOff - 3 + 2), 10, WHITE);
         break;
       }
@@ -673,9 +735,9 @@ void ControlPanel::DrawTooltips() {
 }
 
 void ControlPanel::DrawScrollbar() {
-  if (player.inventoryNodes.size() * NODE_INV_ITEM_HEIGHT >
+  if (GetInventoryRowCount() * NODE_INV_ITEM_HEIGHT >
       panelInventoryArea.height) {
-    float contentHeight = player.inventoryNodes.size() * NODE_INV_ITEM_HEIGHT;
+    float contentHeight = GetInventoryRowCount() * NODE_INV_ITEM_HEIGHT;
     float viewableRatio = panelInventoryArea.height / contentHeight;
     float scrollbarHeight = panelInventoryArea.height * viewableRatio;
     float scrollRatio = (contentHeight > panelInventoryArea.height &&
@@ -1,6 +1,11 @@
 #pragma once
+#include "BuildAnalyzer.h"
+#include "FrameArena.h"
+#include "NodesController.h"
 #include "Player.h"
+#include "RenderSnapshot.h"
 #include "SpriteManager.h"
+#include "UiLayer.h"
 #include "raylib.h"
 
 class Player;
@@ -8,12 +13,27 @@ class BaseNode;
 
 class ControlPanel {
 public:
-  ControlPanel(Player &player, SpriteManager &spriteManager);
+  ControlPanel(Player &player, SpriteManager &spriteManager,
+               NodesController &nodesController, FrameArena &frameArena);
   ~ControlPanel() = default;
 
   void Initialize(int screenWidth, int screenHeight);
-  void Update(Player &player, float dt);
-  void Draw(const Player &player);
+  // The graph structure is read from Player, which only the main thread
+  // edits; inventory and action state are read from the snapshot because
+  // the simulation changes them while the panel is open.
+  void Update(const RenderSnapshot &snapshot, float dt);
+  // The panel is retained: Paint repaints the parts whose content changed
+  // into a cached layer and has to run before the overlay pass; Draw then
+  // shows the layer plus whatever follows the cursor.
+  void Paint(const RenderSnapshot &snapshot);
+  void Draw(const RenderSnapshot &snapshot);
+  void Unload() { layer.Unload(); }
+  // Off paints straight to the overlay; see UiLayer
+  void SetCached(bool cache) { layer.SetCached(cache); }
+
+  // True when this frame's Update will place, remove or link nodes, so the
+  // caller has to hold the simulation paused around it
+  bool WillEditGraph() const;
 
   bool IsOpen() const { return isPanelOpen; }
   void SetOpen(bool open) { isPanelOpen = open; }
@@ -32,7 +52,16 @@ private:
   int connectingNodeFromId;
   Vector2 startCameraDraggingPos;
   Player &player;
+  const RenderSnapshot *snapshot;
+  BuildEstimate estimate; // Redone in Update whenever the graph changes
+  uint64_t estimateKey;
+  UiLayer layer;
+  UiWidget frameWidget; // The whole panel, painted only after a layout
+  UiWidget inventoryWidget;
+  UiWidget gridWidget;
   SpriteManager &spriteManager;
+  NodesController &nodesController;
+  FrameArena &frameArena; // Scratch for the frame's repaints
 
   static const float NODE_UI_SIZE;
   static const float NODE_INV_ITEM_HEIGHT;
@@ -45,11 +74,28 @@ private:
   void HandleNodeRemoval();
   void HandleCameraMove();
 
+  // Inventory rows are fixed height, so the visible range and the row under
+  // the cursor are computed from the scroll offset instead of scanning.
+  Rectangle GetInventoryRowRect(int row) const;
+  int GetInventoryRowAt(Vector2 mousePos) const;
+  void GetVisibleInventoryRows(int &first, int &last) const;
+  int GetInventoryRowCount() const;
+
+  // Content keys: what each widget shows, and what the estimate reads
+  uint64_t GetGraphKey() const;
+  uint64_t GetInventoryKey() const;
+  uint64_t GetGridKey() const;
+
+  void DrawBackdrop(Rectangle area);
+  void DrawFrame();
   void DrawInventoryArea();
+  void DrawInventoryHover();
   void DrawGridArea();
   void DrawConnections();
+  void DrawConnectionPreview();
   void DrawNodes();
   void DrawDraggedNode();
   void DrawTooltips();
+  void DrawEstimate();
   void DrawScrollbar();
 };
@@ -0,0 +1,56 @@
+#include "DynamicResolution.h"
+#include <cmath>
+
+const float DynamicResolution::SCALE_STEP = 0.125f;
+const float DynamicResolution::SMOOTHING = 0.1f;
+// With vsync an on-time frame presents right at the budget, so late means
+// clearly past it
+const float DynamicResolution::LATE_FACTOR = 1.05f;
+const int DynamicResolution::SETTLE_FRAMES = 30;
+
+DynamicResolution::DynamicResolution(float frameBudget, float minScale,
+                                     float maxScale)
+    : enabled(false), frameBudget(frameBudget), minScale(minScale),
+      maxScale(maxScale), scale(maxScale), averagePresentInterval(0.0f),
+      averageWorkTime(0.0f), framesSinceChange(0) {}
+
+void DynamicResolution::SetEnabled(bool enable) {
+  enabled = enable;
+  averagePresentInterval = 0.0f;
+  averageWorkTime = 0.0f;
+  framesSinceChange = 0;
+  if (!enabled)
+    scale = maxScale;
+}
+
+static float Smooth(float average, float sample, float smoothing) {
+  return average == 0.0f ? sample : average + (sample - average) * smoothing;
+}
+
+float DynamicResolution::Update(float presentInterval, float workTime) {
+  if (!enabled)
+    return scale;
+
+  averagePresentInterval =
+      Smooth(averagePresentInterval, presentInterval, SMOOTHING);
+  averageWorkTime = Smooth(averageWorkTime, workTime, SMOOTHING);
+
+  // Give the new target a few frames before judging it again
+  if (++framesSinceChange < SETTLE_FRAMES)
+    return scale;
+
+  float newScale = scale;
+  if (averagePresentInterval > frameBudget * LATE_FACTOR)
+    newScale = fmaxf(minScale, scale - SCALE_STEP);
+  // Vsync hides GPU headroom inside the swap, so on-time frames grow again
+  // on the CPU work alone; a scale the GPU can't keep up with presents
+  // late and steps back down
+  else if (averageWorkTime < frameBudget * 0.75f)
+    newScale = fminf(maxScale, scale + SCALE_STEP);
+
+  if (newScale != scale) {
+    scale = newScale;
+    framesSinceChange = 0;
+  }
+  return scale;
+}
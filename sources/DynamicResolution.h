@@ -0,0 +1,38 @@
+#pragma once
+
+// Picks the scene render scale from measured frame timings. The scale is
+// lowered when frames present late, whether the CPU or the GPU held them
+// up, and raised again once there is headroom. Changes are quantised and
+// rate-limited because each one reallocates the scene render target.
+class DynamicResolution {
+private:
+  bool enabled;
+  float frameBudget;
+  float minScale;
+  float maxScale;
+  float scale;
+  float averagePresentInterval;
+  float averageWorkTime;
+  int framesSinceChange;
+
+  static const float SCALE_STEP;
+  static const float SMOOTHING;
+  static const float LATE_FACTOR;
+  static const int SETTLE_FRAMES;
+
+public:
+  DynamicResolution(float frameBudget = 1.0f / 60.0f, float minScale = 0.5f,
+                    float maxScale = 1.0f);
+
+  void SetEnabled(bool enable);
+  bool IsEnabled() const { return enabled; }
+  void SetFrameBudget(float budget) { frameBudget = budget; }
+
+  // Feed the last frame's timings after it was presented: the interval
+  // since the previous present and the CPU work before the swap, both
+  // without pacing sleeps (see FramePacer). Returns the scale to render
+  // the next frame at.
+  float Update(float presentInterval, float workTime);
+  float GetScale() const { return scale; }
+  float GetAveragePresentInterval() const { return averagePresentInterval; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include "EntityStore.h"
+#include "raylib.h"
+
+// Entity kinds the gameplay systems share, as components of archetype
+// stores (see EntityStore.h). Each pass iterates only the columns it reads.
+
+const int PLAYER_SIZE = 20;
+const int ENEMY_SIZE = 25;
+const int BULLET_SPEED = 800;
+const int BULLET_RADIUS = 5;
+const int MAX_BULLETS = 4096; // Shared by player shots and enemy volleys
+const int MAX_ENEMIES = 10;
+// Damage per second an enemy deals while touching the player
+const int ENEMY_CONTACT_DPS = 600;
+
+// Bullets: where they are and where they're going, read by every bullet
+// pass, and what they do on a hit, read only by collisions and drawing
+struct Motion {
+  Vector2 position;
+  Vector2 velocity;
+};
+
+struct Projectile {
+  Color color;
+  int damage;
+  bool fromPlayer;
+};
+
+using BulletStore = EntityStore<Motion, Projectile>;
+
+// Enemies: steering and collisions read the body, only firing reads the gun
+struct EnemyBody {
+  Vector2 position;
+  float speed;
+  int health;
+  float contactDamage; // Owed to the player but under a whole point yet
+};
+
+struct EnemyGun {
+  float shootCooldown;
+  float currentShootTimer;
+  int pattern;        // Index into the world's bullet patterns
+  float patternPhase; // Degrees a spiral has turned so far
+};
+
+using EnemyStore = EntityStore<EnemyBody, EnemyGun>;
@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Fixed-capacity table for one archetype: every entity in it has the same
+// set of components. Rows live in 16 KB chunks, and inside a chunk each
+// component has its own contiguous column, so a pass that only touches
+// positions streams through positions and nothing else.
+//
+// Slots are stable: an entity keeps its slot until it dies, so systems can
+// index per-entity scratch arrays by slot and parallel passes that only
+// write their own slot stay deterministic. Which dead slot a spawn reuses
+// is up to the caller.
+template <typename... Components> class EntityStore {
+  static_assert(sizeof...(Components) > 0, "an archetype needs components");
+  static_assert((std::is_trivially_copyable<Components>::value && ...),
+                "components are copied as raw bytes");
+
+public:
+  static constexpr size_t CHUNK_BYTES = 16 * 1024;
+  // Largest power of two whose columns (plus the live flags) fit a chunk,
+  // so slot to chunk/row is a shift and a mask
+  static constexpr int CHUNK_ROWS = [] {
+    size_t rowBytes = 1 + (sizeof(Components) + ...);
+    int rows = 1;
+    while (rows * 2 * rowBytes <= CHUNK_BYTES)
+      rows *= 2;
+    return rows;
+  }();
+
+  EntityStore() : capacity(0) {}
+  explicit EntityStore(int capacity) : capacity(0) { Resize(capacity); }
+
+  // Disable copy and move operations
+  EntityStore(const EntityStore &) = delete;
+  EntityStore &operator=(const EntityStore &) = delete;
+  EntityStore(EntityStore &&) = delete;
+  EntityStore &operator=(EntityStore &&) = delete;
+
+  // Allocates every chunk up front, so spawning never allocates. Kills
+  // every entity and zeroes their components.
+  void Resize(int capacity) {
+    this->capacity = capacity;
+    chunks.clear();
+    for (int i = 0; i < (capacity + CHUNK_ROWS - 1) / CHUNK_ROWS; i++)
+      chunks.emplace_back(new Chunk());
+  }
+  // Same-capacity stores only; for benchmarks that restore a fixed layout
+  void CopyFrom(const EntityStore &other) {
+    for (size_t i = 0; i < chunks.size() && i < other.chunks.size(); i++)
+      *chunks[i] = *other.chunks[i];
+  }
+  // Kills every entity; components keep their stale values
+  void Clear() {
+    for (int chunk = 0; chunk < (int)chunks.size(); chunk++)
+      memset(Live(chunk), 0, CHUNK_ROWS);
+  }
+
+  int GetCapacity() const { return capacity; }
+  // Bytes held by the chunks, live or not
+  size_t GetMemoryBytes() const { return chunks.size() * sizeof(Chunk); }
+
+  bool IsAlive(int slot) const { return Live(ChunkOf(slot))[RowOf(slot)]; }
+  // Marks the slot live or dead; components are left as they were
+  void SetAlive(int slot, bool alive) {
+    Live(ChunkOf(slot))[RowOf(slot)] = alive;
+  }
+  // First dead slot at or after from, or the capacity when there is none
+  int FindFree(int from) const {
+    while (from < capacity && IsAlive(from))
+      from++;
+    return from;
+  }
+
+  template <typename C> C &Get(int slot) {
+    return Column<C>(ChunkOf(slot))[RowOf(slot)];
+  }
+  template <typename C> const C &Get(int slot) const {
+    return Column<C>(ChunkOf(slot))[RowOf(slot)];
+  }
+
+  // Calls fn(firstSlot, rows, live, columns...) once per chunk piece of
+  // [begin, end): live and the component columns point at firstSlot's row.
+  // Ranges from a parallel split touch disjoint rows.
+  template <typename Fn> void ForRange(int begin, int end, Fn &&fn) {
+    while (begin < end) {
+      int chunk = ChunkOf(begin);
+      int row = RowOf(begin);
+      int rows = std::min(end - begin, CHUNK_ROWS - row);
+      fn(begin, rows, Live(chunk) + row, (Column<Components>(chunk) + row)...);
+      begin += rows;
+    }
+  }
+  template <typename Fn> void ForEachChunk(Fn &&fn) {
+    ForRange(0, capacity, fn);
+  }
+
+  // Calls fn(slot, components...) for every live entity in slot order
+  template <typename Fn> void ForEachAlive(Fn &&fn) {
+    ForEachChunk([&](int first, int rows, unsigned char *live,
+                     Components *...columns) {
+      for (int r = 0; r < rows; r++)
+        if (live[r])
+          fn(first + r, columns[r]...);
+    });
+  }
+  template <typename Fn> void ForEachAlive(Fn &&fn) const {
+    for (int chunk = 0; chunk < (int)chunks.size(); chunk++) {
+      int rows = std::min(capacity - chunk * CHUNK_ROWS, CHUNK_ROWS);
+      const unsigned char *live = Live(chunk);
+      for (int r = 0; r < rows; r++)
+        if (live[r])
+          fn(chunk * CHUNK_ROWS + r, Column<Components>(chunk)[r]...);
+    }
+  }
+
+private:
+  static constexpr size_t COUNT = sizeof...(Components);
+
+  // Byte offset of each column inside a chunk; the last entry is the live
+  // flags
+  static constexpr std::array<size_t, COUNT + 1> OFFSETS = [] {
+    const size_t sizes[] = {sizeof(Components)...};
+    const size_t alignments[] = {alignof(Components)...};
+    std::array<size_t, COUNT + 1> offsets = {};
+    size_t offset = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+      offset = (offset + alignments[i] - 1) / alignments[i] * alignments[i];
+      offsets[i] = offset;
+      offset += sizes[i] * CHUNK_ROWS;
+    }
+    offsets[COUNT] = offset;
+    return offsets;
+  }();
+  static_assert(OFFSETS[COUNT] + CHUNK_ROWS <= CHUNK_BYTES,
+                "columns overflow the chunk");
+
+  template <typename C> static constexpr size_t IndexOf() {
+    const bool matches[] = {std::is_same<C, Components>::value...};
+    size_t index = 0;
+    while (index < COUNT && !matches[index])
+      index++;
+    return index;
+  }
+
+  struct alignas(64) Chunk {
+    unsigned char bytes[CHUNK_BYTES];
+  };
+
+  int capacity;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+
+  static int ChunkOf(int slot) { return (unsigned)slot / CHUNK_ROWS; }
+  static int RowOf(int slot) { return (unsigned)slot % CHUNK_ROWS; }
+
+  template <typename C> C *Column(int chunk) {
+    static_assert(IndexOf<C>() < COUNT, "not a component of this archetype");
+    return reinterpret_cast<C *>(chunks[chunk]->bytes +
+                                 OFFSETS[IndexOf<C>()]);
+  }
+  template <typename C> const C *Column(int chunk) const {
+    static_assert(IndexOf<C>() < COUNT, "not a component of this archetype");
+    return reinterpret_cast<const C *>(chunks[chunk]->bytes +
+                                       OFFSETS[IndexOf<C>()]);
+  }
+  unsigned char *Live(int chunk) {
+    return chunks[chunk]->bytes + OFFSETS[COUNT];
+  }
+  const unsigned char *Live(int chunk) const {
+    return chunks[chunk]->bytes + OFFSETS[COUNT];
+  }
+};
@@ -0,0 +1,179 @@
+#include "FlowField.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+FlowField::FlowField(float cellSize)
+    : cellSize(cellSize), columns(0), rows(0), targetColumn(-1),
+      targetRow(-1), target({0, 0}) {}
+
+void FlowField::Resize(int width, int height) {
+  columns = std::max(1, (int)ceilf(width / cellSize));
+  rows = std::max(1, (int)ceilf(height / cellSize));
+  headingX.assign(columns * rows, 0.0f);
+  headingY.assign(columns * rows, 0.0f);
+  targetColumn = -1;
+  targetRow = -1;
+}
+
+int FlowField::ColumnOf(float x) const {
+  return std::min(columns - 1, std::max(0, (int)floorf(x / cellSize)));
+}
+
+int FlowField::RowOf(float y) const {
+  return std::min(rows - 1, std::max(0, (int)floorf(y / cellSize)));
+}
+
+bool FlowField::Update(Vector2 target) {
+  this->target = target;
+  int column = ColumnOf(target.x);
+  int row = RowOf(target.y);
+  if (column == targetColumn && row == targetRow)
+    return false;
+  targetColumn = column;
+  targetRow = row;
+
+  // The arena is open, so the shortest path from a cell is the straight
+  // line to the target cell
+  for (int y = 0; y < rows; y++) {
+    for (int x = 0; x < columns; x++) {
+      float dx = (float)(column - x);
+      float dy = (float)(row - y);
+      float length = sqrtf(dx * dx + dy * dy);
+      float scale = length > 0.0f ? 1.0f / length : 0.0f;
+      headingX[y * columns + x] = dx * scale;
+      headingY[y * columns + x] = dy * scale;
+    }
+  }
+  return true;
+}
+
+Vector2 FlowField::Sample(Vector2 position) const {
+  int column = ColumnOf(position.x);
+  int row = RowOf(position.y);
+  if (abs(column - targetColumn) <= 1 && abs(row - targetRow) <= 1) {
+    float dx = target.x - position.x;
+    float dy = target.y - position.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length == 0.0f)
+      return {0, 0};
+    return {dx / length, dy / length};
+  }
+  int cell = row * columns + column;
+  return {headingX[cell], headingY[cell]};
+}
+
+SeparationGrid::SeparationGrid(float cellSize)
+    : cellSize(cellSize), columns(0), rows(0) {}
+
+void SeparationGrid::Resize(int width, int height) {
+  columns = std::max(1, (int)ceilf(width / cellSize));
+  rows = std::max(1, (int)ceilf(height / cellSize));
+  cellStart.assign(columns * rows + 1, 0);
+}
+
+void SeparationGrid::Reserve(int count) {
+  sortedX.reserve(count);
+  sortedY.reserve(count);
+  sortedId.reserve(count);
+  sortedCell.reserve(count);
+  entryCell.reserve(count);
+}
+
+int SeparationGrid::CellOf(Vector2 position) const {
+  int column =
+      std::min(columns - 1, std::max(0, (int)floorf(position.x / cellSize)));
+  int row = std::min(rows - 1, std::max(0, (int)floorf(position.y / cellSize)));
+  return row * columns + column;
+}
+
+void SeparationGrid::Build(const std::vector<Vector2> &positions,
+                           const std::vector<int> &ids) {
+  size_t count = positions.size();
+  std::fill(cellStart.begin(), cellStart.end(), 0);
+  entryCell.resize(count);
+  for (size_t k = 0; k < count; k++) {
+    entryCell[k] = CellOf(positions[k]);
+    cellStart[entryCell[k] + 1]++;
+  }
+  for (size_t cell = 1; cell < cellStart.size(); cell++)
+    cellStart[cell] += cellStart[cell - 1];
+
+  // Stable scatter: within a cell, entries keep their input order
+  sortedX.resize(count);
+  sortedY.resize(count);
+  sortedId.resize(count);
+  sortedCell.resize(count);
+  cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+  for (size_t k = 0; k < count; k++) {
+    int slot = cellCursor[entryCell[k]]++;
+    sortedX[slot] = positions[k].x;
+    sortedY[slot] = positions[k].y;
+    sortedId[slot] = ids[k];
+    sortedCell[slot] = entryCell[k];
+  }
+}
+
+// Adds the push away from one neighbour to every entry in [begin, end).
+// The entries are contiguous and independent, and the loop has no
+// branches (entries out of range and the neighbour itself add zero), so
+// it compiles to vector code without reordering any entry's sum.
+static inline void AddPushes(float neighbourX, float neighbourY,
+                             int neighbourId, const float *xs, const float *ys,
+                             const int *ids, int begin, int end, float range,
+                             float *pushX, float *pushY) {
+  for (int k = begin; k < end; k++) {
+    float dx = xs[k] - neighbourX;
+    float dy = ys[k] - neighbourY;
+    float distanceSqr = dx * dx + dy * dy;
+    bool near = (distanceSqr < range * range) & (ids[k] != neighbourId);
+    float distance = sqrtf(distanceSqr);
+    float depth = 1.0f - distance / range;
+    // Stacked exactly: split the pair along x by id
+    bool stacked = distanceSqr == 0.0f;
+    float side = neighbourId < ids[k] ? 1.0f : -1.0f;
+    float awayX = stacked ? side : dx / distance * depth;
+    float awayY = stacked ? 0.0f : dy / distance * depth;
+    pushX[k] += near ? awayX : 0.0f;
+    pushY[k] += near ? awayY : 0.0f;
+  }
+}
+
+void SeparationGrid::Push(int begin, int end, float *pushX,
+                          float *pushY) const {
+  const float *xs = sortedX.data();
+  const float *ys = sortedY.data();
+  const int *ids = sortedId.data();
+
+  // Entries of one cell share their neighbours, so each neighbour is
+  // applied to the whole run of the cell's entries at once
+  for (int first = begin; first < end;) {
+    int cell = sortedCell[first];
+    int last = std::min(end, cellStart[cell + 1]);
+    std::fill(pushX + first, pushX + last, 0.0f);
+    std::fill(pushY + first, pushY + last, 0.0f);
+
+    int column = cell % columns;
+    int row = cell / columns;
+    int firstColumn = std::max(0, column - 1);
+    int lastColumn = std::min(columns - 1, column + 1);
+    int firstRow = std::max(0, row - 1);
+    int lastRow = std::min(rows - 1, row + 1);
+    for (int y = firstRow; y <= lastRow; y++) {
+      // The cells of a row are contiguous in the sorted arrays
+      int neighbourEnd = cellStart[y * columns + lastColumn + 1];
+      for (int j = cellStart[y * columns + firstColumn]; j < neighbourEnd;
+           j++)
+        AddPushes(xs[j], ys[j], ids[j], xs, ys, ids, first, last, cellSize,
+                  pushX, pushY);
+    }
+    first = last;
+  }
+}
+
+size_t SeparationGrid::GetMemoryBytes() const {
+  return (cellStart.capacity() + sortedId.capacity() + sortedCell.capacity() +
+          entryCell.capacity() + cellCursor.capacity()) *
+             sizeof(int) +
+         (sortedX.capacity() + sortedY.capacity()) * sizeof(float);
+}
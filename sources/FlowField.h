@@ -0,0 +1,84 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <vector>
+
+// Coarse steering field toward a target. Each cell stores the unit
+// direction from its centre to the target's cell, so enemies look up a
+// heading instead of normalising their own vector every tick. The field is
+// only rebuilt when the target moves to another cell. Inside the target's
+// own neighbourhood the cell heading is too coarse, so Sample steers
+// straight at the target there.
+class FlowField {
+public:
+  explicit FlowField(float cellSize = 64.0f);
+
+  void Resize(int width, int height);
+  // Returns true when the target changed cell and the field was rebuilt
+  bool Update(Vector2 target);
+  // Unit heading toward the target, zero on top of it
+  Vector2 Sample(Vector2 position) const;
+
+  int GetColumns() const { return columns; }
+  int GetRows() const { return rows; }
+  size_t GetMemoryBytes() const {
+    return (headingX.capacity() + headingY.capacity()) * sizeof(float);
+  }
+
+private:
+  float cellSize;
+  int columns;
+  int rows;
+  int targetColumn; // -1 until the first Update
+  int targetRow;
+  Vector2 target;
+  std::vector<float> headingX; // Per cell, row-major
+  std::vector<float> headingY;
+
+  int ColumnOf(float x) const;
+  int RowOf(float y) const;
+};
+
+// Positions bucketed by cell with a counting sort, for neighbour queries
+// within one cell size. Keeps its own sorted copy of the positions as
+// plain float arrays, so callers may move the originals while querying and
+// the queries stream through contiguous memory. Cell and in-cell order
+// follow id order, which keeps sums over neighbours deterministic.
+class SeparationGrid {
+public:
+  explicit SeparationGrid(float cellSize);
+
+  void Resize(int width, int height);
+  // Sizes the arrays for count entries, so Build doesn't allocate below it
+  void Reserve(int count);
+  // positions[k] belongs to ids[k]
+  void Build(const std::vector<Vector2> &positions,
+             const std::vector<int> &ids);
+
+  // For each sorted entry in [begin, end), the sum of unit pushes away from
+  // every other entry closer than the cell size, each scaled by how deep
+  // the overlap is (0..1). Written to pushX/pushY at the sorted index.
+  void Push(int begin, int end, float *pushX, float *pushY) const;
+
+  // Entries in sorted order, valid until the next Build
+  int GetCount() const { return (int)sortedId.size(); }
+  float GetX(int k) const { return sortedX[k]; }
+  float GetY(int k) const { return sortedY[k]; }
+  int GetId(int k) const { return sortedId[k]; }
+
+  size_t GetMemoryBytes() const;
+
+private:
+  float cellSize;
+  int columns;
+  int rows;
+  std::vector<int> cellStart; // columns * rows + 1 offsets into the arrays
+  std::vector<float> sortedX;
+  std::vector<float> sortedY;
+  std::vector<int> sortedId;
+  std::vector<int> sortedCell;
+  std::vector<int> entryCell;  // Scratch for Build
+  std::vector<int> cellCursor; // Scratch for Build
+
+  int CellOf(Vector2 position) const;
+};
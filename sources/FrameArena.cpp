@@ -0,0 +1,76 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+static const unsigned char POISON_BYTE = 0xDD;
+
+FrameArena::FrameArena(size_t blockSize)
+    : offset(0), used(0), highWaterMark(0), overflowCount(0),
+#ifdef NDEBUG
+      poisoning(false),
+#else
+      poisoning(true),
+#endif
+      last(nullptr) {
+  AddBlock(blockSize);
+}
+
+FrameArena::~FrameArena() { FreeBlocks(); }
+
+void FrameArena::AddBlock(size_t size) {
+  blocks.push_back({new char[size], size});
+  offset = 0;
+}
+
+void FrameArena::FreeBlocks() {
+  for (Block &block : blocks)
+    delete[] block.memory;
+  blocks.clear();
+}
+
+void *FrameArena::Allocate(size_t size, size_t alignment) {
+  const Block &block = blocks.back();
+  uintptr_t base = (uintptr_t)block.memory;
+  uintptr_t aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+  size_t start = (size_t)(aligned - base);
+  if (start + size > block.size) {
+    // Room for this allocation at any alignment, and at least a block
+    AddBlock(std::max(block.size, size + alignment));
+    overflowCount++;
+    return Allocate(size, alignment);
+  }
+
+  used += start + size - offset;
+  highWaterMark = std::max(highWaterMark, used);
+  offset = start + size;
+  last = block.memory + start;
+  return last;
+}
+
+void FrameArena::Deallocate(void *pointer, size_t size) {
+  if (poisoning)
+    memset(pointer, POISON_BYTE, size);
+  // A container growing in place hands back its latest allocation
+  if (pointer == last) {
+    size_t start = (size_t)((char *)pointer - blocks.back().memory);
+    used -= offset - start;
+    offset = start;
+    last = nullptr;
+  }
+}
+
+void FrameArena::Reset() {
+  if (blocks.size() > 1) {
+    // Settle on one block that fits the busiest frame with some slack
+    size_t size =
+        std::max(blocks.front().size, highWaterMark + highWaterMark / 4);
+    FreeBlocks();
+    AddBlock(size);
+  } else if (poisoning) {
+    memset(blocks.back().memory, POISON_BYTE, offset);
+  }
+  offset = 0;
+  used = 0;
+  last = nullptr;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of the frame, such
+// as scratch vectors in the panel's repaints. Allocating is a
+// pointer bump; freeing is a no-op except for the latest allocation, and
+// Reset hands everything back at once. Main thread only.
+//
+// When a frame outgrows the block, extra blocks are taken from the heap and
+// the next Reset replaces them all with one block sized to the high-water
+// mark, so steady frames settle into a single block and never allocate.
+//
+// With poisoning on (the default in debug builds) freed and reset memory is
+// overwritten with 0xDD, so anything still pointing into it shows up fast.
+class FrameArena {
+public:
+  explicit FrameArena(size_t blockSize = 64 * 1024);
+  ~FrameArena();
+
+  // Disable copy and move operations
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+  FrameArena(FrameArena &&) = delete;
+  FrameArena &operator=(FrameArena &&) = delete;
+
+  void *Allocate(size_t size, size_t alignment);
+  void Deallocate(void *pointer, size_t size);
+
+  // Frees everything; nothing allocated since the last Reset may be used
+  // after it
+  void Reset();
+
+  void SetPoisoning(bool poison) { poisoning = poison; }
+  bool IsPoisoning() const { return poisoning; }
+
+  // Bytes in use this frame, the most any frame has used, and the blocks
+  // taken from the heap beyond the first since startup
+  size_t GetUsed() const { return used; }
+  size_t GetHighWaterMark() const { return highWaterMark; }
+  int GetOverflowCount() const { return overflowCount; }
+
+private:
+  struct Block {
+    char *memory;
+    size_t size;
+  };
+
+  std::vector<Block> blocks; // The current block is the last one
+  size_t offset;             // Into the current block
+  size_t used;
+  size_t highWaterMark;
+  int overflowCount;
+  bool poisoning;
+  void *last; // Latest allocation, the only one Deallocate can take back
+
+  void AddBlock(size_t size);
+  void FreeBlocks();
+};
+
+// Standard allocator over a FrameArena, for containers that must not
+// outlive the frame
+template <typename T> class FrameAllocator {
+public:
+  typedef T value_type;
+
+  explicit FrameAllocator(FrameArena &arena) : arena(&arena) {}
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U> &other) : arena(other.arena) {}
+
+  T *allocate(size_t count) {
+    return (T *)arena->Allocate(count * sizeof(T), alignof(T));
+  }
+  void deallocate(T *pointer, size_t count) {
+    arena->Deallocate(pointer, count * sizeof(T));
+  }
+
+  template <typename U> bool operator==(const FrameAllocator<U> &other) const {
+    return arena == other.arena;
+  }
+  template <typename U> bool operator!=(const FrameAllocator<U> &other) const {
+    return arena != other.arena;
+  }
+
+  FrameArena *arena;
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
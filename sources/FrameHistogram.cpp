@@ -0,0 +1,109 @@
+#include "FrameHistogram.h"
+#include <algorithm>
+
+FrameHistogram::FrameHistogram(const char *name)
+    : name(name),
+      counts(SUB_BUCKET_COUNT +
+             (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF),
+      count(0), min(UINT64_MAX), max(0), sum(0.0) {}
+
+int FrameHistogram::BucketIndex(uint64_t value) {
+  if (value < (uint64_t)SUB_BUCKET_COUNT)
+    return (int)value;
+  int msb = 63;
+  while (!(value >> msb))
+    msb--;
+  // Shift so the value lands in [SUB_BUCKET_HALF, SUB_BUCKET_COUNT)
+  int shift = msb - (SUB_BUCKET_BITS - 1);
+  return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF +
+         (int)((value >> shift) - SUB_BUCKET_HALF);
+}
+
+uint64_t FrameHistogram::BucketLowest(int index) {
+  if (index < SUB_BUCKET_COUNT)
+    return (uint64_t)index;
+  int shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+  uint64_t subBucket =
+      (uint64_t)((index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF +
+                 SUB_BUCKET_HALF);
+  return subBucket << shift;
+}
+
+uint64_t FrameHistogram::BucketHighest(int index) {
+  if (index < SUB_BUCKET_COUNT)
+    return (uint64_t)index;
+  int shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+  return BucketLowest(index) + (1ull << shift) - 1;
+}
+
+void FrameHistogram::Record(uint64_t microseconds) {
+  int index = std::min(BucketIndex(microseconds), (int)counts.size() - 1);
+  counts[index]++;
+  count++;
+  sum += (double)microseconds;
+  min = std::min(min, microseconds);
+  max = std::max(max, microseconds);
+}
+
+void FrameHistogram::RecordSeconds(double seconds) {
+  Record(seconds > 0.0 ? (uint64_t)(seconds * 1e6 + 0.5) : 0);
+}
+
+void FrameHistogram::Reset() {
+  std::fill(counts.begin(), counts.end(), 0);
+  count = 0;
+  min = UINT64_MAX;
+  max = 0;
+  sum = 0.0;
+}
+
+double FrameHistogram::GetMean() const {
+  return count ? sum / (double)count : 0.0;
+}
+
+uint64_t FrameHistogram::GetPercentile(double percentile) const {
+  if (count == 0)
+    return 0;
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  uint64_t target = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+  target = std::max<uint64_t>(target, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); i++) {
+    seen += counts[i];
+    if (seen >= target)
+      return std::min(BucketHighest((int)i), max);
+  }
+  return max;
+}
+
+void FrameHistogram::Print(FILE *file, bool withDistribution) const {
+  fprintf(file,
+          "%-8s n=%llu mean=%.2fms p50=%.2fms p95=%.2fms p99=%.2fms "
+          "p99.9=%.2fms max=%.2fms\n",
+          name, (unsigned long long)count, GetMean() / 1000.0,
+          GetPercentile(50.0) / 1000.0, GetPercentile(95.0) / 1000.0,
+          GetPercentile(99.0) / 1000.0, GetPercentile(99.9) / 1000.0,
+          max / 1000.0);
+
+  if (!withDistribution || count == 0)
+    return;
+
+  // Same columns as HdrHistogram's percentile output
+  fprintf(file, "%12s %14s %10s %14s\n", "Value(ms)", "Percentile",
+          "TotalCount", "1/(1-Percentile)");
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); i++) {
+    if (counts[i] == 0)
+      continue;
+    seen += counts[i];
+    double fraction = (double)seen / (double)count;
+    uint64_t value = std::min(BucketHighest((int)i), max);
+    if (fraction < 1.0)
+      fprintf(file, "%12.3f %14.12f %10llu %14.2f\n", value / 1000.0,
+              fraction, (unsigned long long)seen, 1.0 / (1.0 - fraction));
+    else
+      fprintf(file, "%12.3f %14.12f %10llu\n", value / 1000.0, fraction,
+              (unsigned long long)seen);
+  }
+}
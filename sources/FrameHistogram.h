@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Log-linear histogram of durations in microseconds, in the style of
+// HdrHistogram: values below 128 us are exact, above that each power of two
+// is split into 64 buckets, so any reported value is within ~1.6% of the
+// recorded one. Recording is O(1) and never allocates.
+class FrameHistogram {
+public:
+  explicit FrameHistogram(const char *name = "frame");
+
+  void Record(uint64_t microseconds);
+  void RecordSeconds(double seconds);
+  void Reset();
+
+  uint64_t GetCount() const { return count; }
+  uint64_t GetMin() const { return count ? min : 0; }
+  uint64_t GetMax() const { return max; }
+  double GetMean() const;
+  // percentile in [0, 100]
+  uint64_t GetPercentile(double percentile) const;
+
+  // One-line p50/p95/p99/max summary, plus the percentile distribution
+  // table when withDistribution is set
+  void Print(FILE *file, bool withDistribution = false) const;
+
+private:
+  static const int SUB_BUCKET_BITS = 7;
+  static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+  static const int SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+  static const int MAX_VALUE_BITS = 36; // ~19 hours
+
+  static int BucketIndex(uint64_t value);
+  static uint64_t BucketLowest(int index);
+  static uint64_t BucketHighest(int index);
+
+  const char *name;
+  std::vector<uint64_t> counts;
+  uint64_t count;
+  uint64_t min;
+  uint64_t max;
+  double sum;
+};
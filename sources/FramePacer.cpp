@@ -0,0 +1,130 @@
+#include "FramePacer.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cstring>
+
+// Slack left before vblank in low-latency mode, covers sleep jitter
+static const double LOW_LATENCY_MARGIN = 0.001;
+
+const char *GetPacingModeName(PacingMode mode) {
+  switch (mode) {
+  case PacingMode::CAPPED:
+    return "capped";
+  case PacingMode::UNCAPPED:
+    return "uncapped";
+  case PacingMode::VSYNC:
+    return "vsync";
+  case PacingMode::LOW_LATENCY:
+    return "low-latency";
+  }
+  return "unknown";
+}
+
+bool ParsePacingMode(const char *name, PacingMode &mode) {
+  const PacingMode modes[] = {PacingMode::CAPPED, PacingMode::UNCAPPED,
+                              PacingMode::VSYNC, PacingMode::LOW_LATENCY};
+  for (PacingMode candidate : modes) {
+    if (strcmp(name, GetPacingModeName(candidate)) == 0) {
+      mode = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+FramePacer::FramePacer()
+    : mode(PacingMode::CAPPED), targetFrameTime(1.0 / 60.0),
+      refreshInterval(1.0 / 60.0), frameStart(0.0), workStart(0.0),
+      lastPresent(0.0), lastPresentInterval(0.0), sleptSincePresent(0.0),
+      lastWorkTime(0.0), workHistory{},
+      workHistoryIndex(0), frameTimes("frame"), workTimes("work") {}
+
+void FramePacer::SetMode(PacingMode newMode, int targetFps) {
+  mode = newMode;
+  targetFrameTime = targetFps > 0 ? 1.0 / targetFps : 0.0;
+
+  int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+  refreshInterval = refreshRate > 0 ? 1.0 / refreshRate : targetFrameTime;
+
+  if (mode == PacingMode::VSYNC || mode == PacingMode::LOW_LATENCY)
+    SetWindowState(FLAG_VSYNC_HINT);
+  else
+    ClearWindowState(FLAG_VSYNC_HINT);
+
+  // Timing of the previous mode says nothing about the new one
+  frameTimes.Reset();
+  workTimes.Reset();
+  frameStart = lastPresent = GetTime();
+  lastPresentInterval = sleptSincePresent = 0.0;
+  TraceLog(LOG_INFO, "PACING: %s", GetPacingModeName(mode));
+}
+
+void FramePacer::CycleMode() {
+  SetMode((PacingMode)(((int)mode + 1) % 4),
+          targetFrameTime > 0.0 ? (int)(1.0 / targetFrameTime + 0.5) : 0);
+}
+
+double FramePacer::PredictWorkTime() const {
+  // The slowest recent frame, so a single spike doesn't miss vblank twice
+  return *std::max_element(workHistory, workHistory + WORK_HISTORY);
+}
+
+float FramePacer::BeginFrame() {
+  if (mode == PacingMode::LOW_LATENCY) {
+    double wakeTime = lastPresent + refreshInterval - PredictWorkTime() -
+                      LOW_LATENCY_MARGIN;
+    double now = GetTime();
+    if (wakeTime > now)
+      Sleep(wakeTime - now);
+  }
+
+  PollInputEvents();
+
+  double now = GetTime();
+  double frameTime = now - frameStart;
+  frameStart = workStart = now;
+  frameTimes.RecordSeconds(frameTime);
+  return (float)frameTime;
+}
+
+void FramePacer::EndFrame() {
+  lastWorkTime = GetTime() - workStart;
+  workHistory[workHistoryIndex] = lastWorkTime;
+  workHistoryIndex = (workHistoryIndex + 1) % WORK_HISTORY;
+  workTimes.RecordSeconds(lastWorkTime);
+
+  SwapScreenBuffer();
+  double now = GetTime();
+  lastPresentInterval = now - lastPresent - sleptSincePresent;
+  lastPresent = now;
+  sleptSincePresent = 0.0;
+
+  if (mode == PacingMode::CAPPED && targetFrameTime > 0.0) {
+    double elapsed = lastPresent - frameStart;
+    if (elapsed < targetFrameTime)
+      Sleep(targetFrameTime - elapsed);
+  }
+}
+
+void FramePacer::Sleep(double seconds) {
+  // Timed rather than assumed, since sleeps overshoot
+  double start = GetTime();
+  WaitTime(seconds);
+  sleptSincePresent += GetTime() - start;
+}
+
+bool FramePacer::DumpStats(const char *path) const {
+  bool toStdout = strcmp(path, "-") == 0;
+  FILE *file = toStdout ? stdout : fopen(path, "w");
+  if (!file)
+    return false;
+
+  fprintf(file, "pacing: %s\n", GetPacingModeName(mode));
+  frameTimes.Print(file, true);
+  fprintf(file, "\n");
+  workTimes.Print(file, true);
+
+  if (!toStdout)
+    fclose(file);
+  return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "FrameHistogram.h"
+
+enum class PacingMode {
+  CAPPED,     // Sleep after present until the target frame time
+  UNCAPPED,   // Run as fast as possible
+  VSYNC,      // Let the swap block on vertical blank
+  LOW_LATENCY // Vsync, but sleep before input sampling so the frame is
+              // built as close to the next vblank as the work allows
+};
+
+const char *GetPacingModeName(PacingMode mode);
+bool ParsePacingMode(const char *name, PacingMode &mode);
+
+// Owns the frame loop timing. raylib is built with
+// SUPPORT_CUSTOM_FRAME_CONTROL, so EndDrawing() no longer swaps, waits or
+// polls input; BeginFrame()/EndFrame() do that here instead.
+class FramePacer {
+public:
+  FramePacer();
+
+  // Needs an open window; vsync is switched on or off to match the mode
+  void SetMode(PacingMode mode, int targetFps = 60);
+  PacingMode GetMode() const { return mode; }
+  void CycleMode();
+
+  // Start of frame: sleeps if the mode wants to, then polls input.
+  // Returns the time since the previous frame started.
+  float BeginFrame();
+  // After EndDrawing(): presents, then sleeps in capped mode
+  void EndFrame();
+
+  // Time spent between BeginFrame() and EndFrame() on the last frame
+  float GetWorkTime() const { return (float)lastWorkTime; }
+  // Time between the last two presents, less the pacer's own sleeps. It
+  // includes any time the swap blocked on the GPU or on vblank.
+  float GetPresentInterval() const { return (float)lastPresentInterval; }
+
+  const FrameHistogram &GetFrameTimes() const { return frameTimes; }
+  const FrameHistogram &GetWorkTimes() const { return workTimes; }
+  // Writes both histograms with their distributions; "-" is stdout
+  bool DumpStats(const char *path) const;
+
+private:
+  static const int WORK_HISTORY = 32;
+
+  PacingMode mode;
+  double targetFrameTime;
+  double refreshInterval;
+
+  double frameStart;
+  double workStart;
+  double lastPresent;
+  double lastPresentInterval;
+  double sleptSincePresent;
+  double lastWorkTime;
+  double workHistory[WORK_HISTORY];
+  int workHistoryIndex;
+
+  FrameHistogram frameTimes;
+  FrameHistogram workTimes;
+
+  double PredictWorkTime() const;
+  void Sleep(double seconds);
+};
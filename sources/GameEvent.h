@@ -0,0 +1,24 @@
+#pragma once
+#include "BaseNode.h"
+#include "MpscQueue.h"
+#include "raylib.h"
+
+enum class GameEventType {
+  ENEMY_KILLED,   // position: where it died
+  ENEMY_HIT,      // position, amount: a player shot that didn't kill
+  PLAYER_HIT,     // amount: contact damage before shields
+  NODE_DROPPED,   // nodeType: added to the inventory
+  ACTION_STARTED, // nodeType, nodeId: the action node that just started
+};
+
+// Side effect of a tick, queued where it happens and applied once per tick
+// by GameWorld::DrainEvents, so collision and action code only record facts
+struct GameEvent {
+  GameEventType type;
+  Vector2 position;
+  int amount;
+  NodeType nodeType;
+  int nodeId;
+};
+
+typedef MpscQueue<GameEvent> GameEventQueue;
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+// Small PCG32 generator owned by each world, so headless runs seeded alike
+// play out alike and never share raylib's global random state
+class GameRandom {
+public:
+  explicit GameRandom(uint64_t seed = 0) { Seed(seed); }
+
+  void Seed(uint64_t seed) {
+    state = 0;
+    Next();
+    state += seed;
+    Next();
+  }
+
+  uint32_t Next() {
+    uint64_t old = state;
+    state = old * 6364136223846793005ull + INCREMENT;
+    uint32_t xorShifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rotation = (uint32_t)(old >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+  }
+
+  // Inclusive on both ends, like GetRandomValue
+  int Range(int min, int max) {
+    if (max < min) {
+      int swap = min;
+      min = max;
+      max = swap;
+    }
+    uint32_t span = (uint32_t)(max - min) + 1u;
+    return min + (int)(Next() % span);
+  }
+
+private:
+  static const uint64_t INCREMENT = 1442695040888963407ull;
+  uint64_t state;
+};
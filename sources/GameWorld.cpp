@@ -0,0 +1,597 @@
+#include "GameWorld.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "Tracer.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+
+// Work per chunk is a few hundred nanoseconds at these sizes, so anything
+// smaller isn't worth handing to another thread
+static const int ENEMY_CHUNK_SIZE = 32;
+static const int BULLET_CHUNK_SIZE = 512;
+
+// Bullet hits one enemy usually takes in a tick
+static const int ENEMY_HITS_RESERVED = 4;
+
+// Events a busy tick raises besides one kill and one contact per enemy:
+// shots that hit without killing, enemy bullets on the player and action
+// starts. Anything past it goes to the overflow list, not the floor.
+static const int EVENTS_RESERVED = 256;
+
+// How hard overlapping enemies push apart, relative to their own speed
+static const float SEPARATION_STRENGTH = 1.5f;
+
+GameWorld::GameWorld(int width, int height, int maxEnemies, int maxBullets)
+    : state(GameState::MAIN_MENU), bullets(maxBullets), width(width),
+      height(height), tickCount(0), jobs(nullptr), profiler(nullptr),
+      enemyFireRate(1.0f), stats(), notifications(nullptr), overflowRead(0),
+      separation(ENEMY_SIZE * 2.0f) {
+  flowField.Resize(width, height);
+  separation.Resize(width, height);
+  playerShots.reserve(maxBullets);
+  SetBulletPatterns({});
+  SetEnemyCapacity(maxEnemies);
+}
+
+void GameWorld::SetEnemyCapacity(int maxEnemies) {
+  enemies.Resize(maxEnemies);
+  bulletHits.assign(maxEnemies, std::vector<int>());
+  // Room for a few hits each, so newly used slots don't allocate mid-run
+  for (std::vector<int> &hits : bulletHits)
+    hits.reserve(ENEMY_HITS_RESERVED);
+  volleyDue.assign(maxEnemies, 0);
+  pushX.assign(maxEnemies, 0.0f);
+  pushY.assign(maxEnemies, 0.0f);
+  steerX.assign(maxEnemies, 0.0f);
+  steerY.assign(maxEnemies, 0.0f);
+  livePositions.reserve(maxEnemies);
+  liveIds.reserve(maxEnemies);
+  separation.Reserve(maxEnemies);
+  freeEnemySlots.reserve(maxEnemies);
+  ResetEnemyPool();
+  ResizeEventQueue();
+}
+
+void GameWorld::SetEnemies(const EnemyStore &layout) {
+  enemies.CopyFrom(layout);
+  freeEnemySlots.clear();
+  for (int i = enemies.GetCapacity() - 1; i >= 0; i--)
+    if (!enemies.IsAlive(i))
+      freeEnemySlots.push_back(i);
+}
+
+void GameWorld::ResetEnemyPool() {
+  // Lowest slots on top, so a fresh pool fills from the front
+  enemies.Clear();
+  freeEnemySlots.clear();
+  for (int i = enemies.GetCapacity() - 1; i >= 0; i--)
+    freeEnemySlots.push_back(i);
+}
+
+void GameWorld::SetBulletPatterns(const std::vector<BulletPattern> &patterns) {
+  this->patterns = patterns.empty() ? GetDefaultBulletPatterns() : patterns;
+  int largest = 0;
+  for (const BulletPattern &pattern : this->patterns)
+    largest = std::max(largest, pattern.count);
+  volleyVelocities.resize(largest);
+  ResolveArchetypePatterns();
+}
+
+bool GameWorld::LoadWaves(const std::string &path) {
+  bool loaded = waveDirector.Load(path);
+  ResolveArchetypePatterns();
+  return loaded;
+}
+
+void GameWorld::ResolveArchetypePatterns() {
+  const std::vector<EnemyArchetype> &archetypes =
+      waveDirector.GetArchetypes();
+  archetypePatterns.assign(archetypes.size(), 0);
+  for (size_t a = 0; a < archetypes.size(); a++) {
+    bool found = false;
+    for (size_t p = 0; p < patterns.size() && !found; p++) {
+      if (patterns[p].name == archetypes[a].pattern) {
+        archetypePatterns[a] = (int)p;
+        found = true;
+      }
+    }
+    if (!found)
+      TraceLog(LOG_WARNING, "WAVES: archetype %s uses unknown pattern %s",
+               archetypes[a].name.c_str(), archetypes[a].pattern.c_str());
+  }
+}
+
+void GameWorld::ResizeEventQueue() {
+  // Sized for a busy tick rather than every bullet hitting at once, which
+  // would make the queue most of a world's memory
+  events.reset(
+      new GameEventQueue(enemies.GetCapacity() * 2 + EVENTS_RESERVED));
+  nodesController.SetEventQueue(events.get());
+}
+
+void GameWorld::PushEvent(const GameEvent &event) {
+  if (events->TryPush(event))
+    return;
+  std::lock_guard<std::mutex> lock(overflowMutex);
+  overflowEvents.push_back(event);
+}
+
+// Overflow comes after the queue: nothing is popped during a tick, so
+// everything pushed after the queue filled overflowed too
+bool GameWorld::PopEvent(GameEvent &event) {
+  if (events->TryPop(event))
+    return true;
+  if (overflowRead < overflowEvents.size()) {
+    event = overflowEvents[overflowRead++];
+    return true;
+  }
+  overflowEvents.clear();
+  overflowRead = 0;
+  return false;
+}
+
+size_t GameWorld::GetMemoryBytes() const {
+  size_t bytes = sizeof(GameWorld);
+  bytes += bullets.GetMemoryBytes() + enemies.GetMemoryBytes();
+  bytes += events->GetMemoryBytes();
+  bytes += overflowEvents.capacity() * sizeof(GameEvent);
+  for (const std::vector<int> &hits : bulletHits)
+    bytes += sizeof(hits) + hits.capacity() * sizeof(int);
+  bytes += playerShots.capacity() * sizeof(SweptShot);
+  bytes += flowField.GetMemoryBytes() + separation.GetMemoryBytes();
+  bytes += livePositions.capacity() * sizeof(Vector2);
+  bytes += (liveIds.capacity() + archetypePatterns.capacity() +
+            freeEnemySlots.capacity()) *
+           sizeof(int);
+  bytes += (pushX.capacity() + pushY.capacity() + steerX.capacity() +
+            steerY.capacity()) *
+           sizeof(float);
+  bytes += patterns.capacity() * sizeof(BulletPattern);
+  bytes += volleyDue.capacity();
+  bytes += volleyVelocities.capacity() * sizeof(Vector2);
+  return bytes;
+}
+
+void GameWorld::ParallelFor(int count, int chunkSize,
+                            const std::function<void(int, int)> &body) {
+  if (jobs)
+    jobs->ParallelFor(count, chunkSize, body);
+  else
+    body(0, count);
+}
+
+void GameWorld::Init() {
+  nodesController.Initialize();
+  player = Player();
+
+  // Create initial CPU core node
+  auto coreNode = nodesController.CreateNodeFromTemplate(NodeType::CPU_CORE);
+  coreNode->panelPosition = {0, 0};
+  coreNode->isPlaced = true;
+  coreNode->isActive = true;
+  player.placedNodes.push_back(std::move(coreNode));
+
+  // Add initial inventory nodes
+  player.AddInventoryNode(NodeType::STAT_HEALTH);
+  player.AddInventoryNode(NodeType::POWER_VALUE_ADD);
+  player.AddInventoryNode(NodeType::ACTION_FIRE);
+  player.AddInventoryNode(NodeType::STAT_DAMAGE);
+  player.AddInventoryNode(NodeType::POWER_DURATION_REDUCE);
+  player.AddInventoryNode(NodeType::ACTION_SHIELD);
+
+  bullets.Clear();
+  ResetEnemyPool();
+  waveDirector.Reset();
+
+  nodesController.UpdateNodeActivation(player);
+  player.currentHealth = player.maxHealth;
+  tickCount = 0;
+  stats = RunStats();
+}
+
+void GameWorld::SpawnWaves(float dt, int liveEnemies) {
+  int count =
+      waveDirector.Update(dt, liveEnemies, (int)freeEnemySlots.size());
+  const WaveSpec &wave = waveDirector.GetCurrentWave();
+  const EnemyArchetype &archetype =
+      waveDirector.GetArchetypes()[wave.archetype];
+  for (int i = 0; i < count; i++)
+    SpawnEnemy(archetype, archetypePatterns[wave.archetype], wave);
+  stats.wave = waveDirector.GetWaveNumber();
+}
+
+void GameWorld::SpawnEnemy(const EnemyArchetype &archetype, int pattern,
+                           const WaveSpec &wave) {
+  int slot = freeEnemySlots.back();
+  freeEnemySlots.pop_back();
+  TRACE_INSTANT("enemy spawn", slot);
+
+  // Somewhere on the ring around the player, pulled back into the arena
+  float angle = (float)random.Range(0, 359) * DEG2RAD;
+  float radius = (float)random.Range((int)wave.ringMin, (int)wave.ringMax);
+  enemies.SetAlive(slot, true);
+  EnemyBody &body = enemies.Get<EnemyBody>(slot);
+  body.position = {
+      Clamp(player.position.x + cosf(angle) * radius, (float)ENEMY_SIZE,
+            (float)(width - ENEMY_SIZE)),
+      Clamp(player.position.y + sinf(angle) * radius, (float)ENEMY_SIZE,
+            (float)(height - ENEMY_SIZE))};
+  body.speed = archetype.speed;
+  body.health = archetype.health;
+  body.contactDamage = 0.0f;
+  EnemyGun &gun = enemies.Get<EnemyGun>(slot);
+  gun.shootCooldown = archetype.shootCooldown / enemyFireRate;
+  gun.currentShootTimer = gun.shootCooldown *
+                          (float)random.Range(0, 100) / 100.0f;
+  gun.pattern = pattern;
+  gun.patternPhase = 0.0f;
+}
+
+void GameWorld::Tick(const PlayerInput &input, float dt) {
+  if (state != GameState::GAMEPLAY)
+    return;
+  ProfileScope tickScope(profiler, ProfileZone::TICK);
+
+  UpdatePlayer(input, dt);
+
+  // Update node system
+  {
+    ProfileScope scope(profiler, ProfileZone::ACTIONS);
+    nodesController.UpdateActionSystem(player, bullets, input.aimPosition,
+                                       dt);
+    player.applyNodeEffects();
+  }
+
+  {
+    ProfileScope scope(profiler, ProfileZone::BULLET_MOTION);
+    UpdateBullets(dt);
+  }
+  {
+    ProfileScope scope(profiler, ProfileZone::HOSTILE_HITS);
+    CollideHostileBullets(dt);
+  }
+  int liveEnemies;
+  {
+    ProfileScope scope(profiler, ProfileZone::ENEMIES);
+    liveEnemies = UpdateEnemies(dt);
+  }
+  {
+    ProfileScope scope(profiler, ProfileZone::ENEMY_FIRE);
+    FireEnemyVolleys();
+  }
+  {
+    ProfileScope scope(profiler, ProfileZone::EVENTS);
+    DrainEvents();
+  }
+
+  if (state == GameState::GAMEPLAY) {
+    ProfileScope scope(profiler, ProfileZone::SPAWNING);
+    SpawnWaves(dt, liveEnemies);
+  }
+  tickCount++;
+  stats.elapsed += dt;
+}
+
+void GameWorld::UpdatePlayer(const PlayerInput &input, float dt) {
+  playerStart = player.position;
+  Vector2 moveDir = input.moveDir;
+  if (moveDir.x != 0.0f || moveDir.y != 0.0f) {
+    float length = sqrtf(moveDir.x * moveDir.x + moveDir.y * moveDir.y);
+    moveDir.x /= length;
+    moveDir.y /= length;
+  }
+
+  player.position.x += moveDir.x * player.currentSpeed * dt;
+  player.position.y += moveDir.y * player.currentSpeed * dt;
+
+  player.position.x =
+      Clamp(player.position.x, (float)PLAYER_SIZE, (float)width - PLAYER_SIZE);
+  player.position.y = Clamp(player.position.y, (float)PLAYER_SIZE,
+                            (float)height - PLAYER_SIZE);
+
+  // Player manual shooting
+  player.fireCooldownTimer -= dt;
+  if (input.fireHeld && player.fireCooldownTimer <= 0) {
+    int slot = bullets.FindFree(0);
+    if (slot < bullets.GetCapacity()) {
+      Vector2 direction = Vector2Normalize(
+          Vector2Subtract(input.aimPosition, player.position));
+      if (Vector2LengthSqr(direction) == 0)
+        direction = {0, -1};
+      bullets.SetAlive(slot, true);
+      bullets.Get<Motion>(slot) = {player.position,
+                                   Vector2Scale(direction, BULLET_SPEED)};
+      bullets.Get<Projectile>(slot) = {YELLOW, player.currentDamage, true};
+      // Carry this tick's overshoot, or coarse ticks would stretch every
+      // cooldown to a whole number of them; time spent idle isn't banked
+      player.fireCooldownTimer =
+          fmaxf(player.fireCooldownTimer, -dt) + player.currentFireRate;
+    }
+  }
+}
+
+void GameWorld::UpdateBullets(float dt) {
+  auto move = [&](int, int rows, unsigned char *live, Motion *motion,
+                  Projectile *) {
+    for (int r = 0; r < rows; r++) {
+      if (!live[r])
+        continue;
+      // Culled a tick after leaving, so the path out of the arena still
+      // gets its collision tests
+      Vector2 &position = motion[r].position;
+      if (position.x < 0 || position.x > width || position.y < 0 ||
+          position.y > height) {
+        live[r] = false;
+        continue;
+      }
+      position = Vector2Add(position, Vector2Scale(motion[r].velocity, dt));
+    }
+  };
+  ParallelFor(bullets.GetCapacity(), BULLET_CHUNK_SIZE,
+              [&](int begin, int end) { bullets.ForRange(begin, end, move); });
+}
+
+void GameWorld::CollideHostileBullets(float dt) {
+  Vector2 playerEnd = player.position;
+  SweptBox playerBox = MakeSweptBox(playerStart, playerEnd, PLAYER_SIZE);
+  bool shielded = player.playerShieldIsActive;
+  auto collide = [&](int, int rows, unsigned char *live, Motion *motion,
+                     Projectile *projectile) {
+    for (int r = 0; r < rows; r++) {
+      if (!live[r] || projectile[r].fromPlayer)
+        continue;
+      Vector2 end = motion[r].position;
+      Vector2 start =
+          Vector2Subtract(end, Vector2Scale(motion[r].velocity, dt));
+      if (!SweptBoxesOverlap(playerBox,
+                             MakeSweptBox(start, end, BULLET_RADIUS)) ||
+          !SweptCirclesTouch(start, end, playerStart, playerEnd,
+                             PLAYER_SIZE + BULLET_RADIUS))
+        continue;
+      live[r] = false;
+      if (!shielded)
+        PushEvent({GameEventType::PLAYER_HIT, end, projectile[r].damage,
+                   NodeType::NONE, -1});
+    }
+  };
+  ParallelFor(bullets.GetCapacity(), BULLET_CHUNK_SIZE,
+              [&](int begin, int end) {
+                bullets.ForRange(begin, end, collide);
+              });
+}
+
+int GameWorld::UpdateEnemies(float dt) {
+  // Enemy volleys share the pool, so only scan the player's own shots
+  playerShots.clear();
+  bullets.ForEachAlive([&](int slot, Motion &motion, Projectile &projectile) {
+    if (!projectile.fromPlayer)
+      return;
+    Vector2 end = motion.position;
+    Vector2 start = Vector2Subtract(end, Vector2Scale(motion.velocity, dt));
+    playerShots.push_back(
+        {slot, start, end, MakeSweptBox(start, end, BULLET_RADIUS)});
+  });
+
+  flowField.Update(player.position);
+  livePositions.clear();
+  liveIds.clear();
+  enemies.ForEachAlive([&](int slot, EnemyBody &body, EnemyGun &) {
+    livePositions.push_back(body.position);
+    liveIds.push_back(slot);
+  });
+  separation.Build(livePositions, liveIds);
+
+  // Steering streams through the grid's sorted float arrays: separation
+  // pushes in fixed-width lanes, then the field heading, dropped against
+  // the player so enemies hold still there but keep separating. It reads
+  // only the grid's copy of the positions and writes each enemy's own
+  // steering slot, so it runs in parallel.
+  const float contactSqr =
+      (float)(PLAYER_SIZE + ENEMY_SIZE) * (PLAYER_SIZE + ENEMY_SIZE);
+  auto steer = [this, contactSqr](int begin, int end) {
+    separation.Push(begin, end, pushX.data(), pushY.data());
+    for (int k = begin; k < end; k++) {
+      Vector2 position = {separation.GetX(k), separation.GetY(k)};
+      Vector2 heading = flowField.Sample(position);
+      float toPlayerX = player.position.x - position.x;
+      float toPlayerY = player.position.y - position.y;
+      bool hold = toPlayerX * toPlayerX + toPlayerY * toPlayerY <= contactSqr;
+      int slot = separation.GetId(k);
+      steerX[slot] =
+          (hold ? 0.0f : heading.x) + pushX[k] * SEPARATION_STRENGTH;
+      steerY[slot] =
+          (hold ? 0.0f : heading.y) + pushY[k] * SEPARATION_STRENGTH;
+    }
+  };
+  ParallelFor(separation.GetCount(), ENEMY_CHUNK_SIZE, steer);
+
+  // Moving and the bullet/player queries only touch their own enemy's
+  // slot. Bullets are not consumed here: each enemy records every bullet
+  // overlapping it, in bullet order. Contact damage is order-independent,
+  // so it is queued straight from the workers.
+  SweptBox playerBox = MakeSweptBox(playerStart, player.position, PLAYER_SIZE);
+  auto update = [&](int first, int rows, unsigned char *live,
+                    EnemyBody *body, EnemyGun *gun) {
+    for (int r = 0; r < rows; r++) {
+      int i = first + r;
+      std::vector<int> &hits = bulletHits[i];
+      hits.clear();
+      if (!live[r])
+        continue;
+
+      Vector2 &position = body[r].position;
+      Vector2 enemyStart = position;
+      float step = body[r].speed * dt;
+      position.x = Clamp(position.x + steerX[i] * step, 0.0f, (float)width);
+      position.y = Clamp(position.y + steerY[i] * step, 0.0f, (float)height);
+
+      gun[r].currentShootTimer -= dt;
+      volleyDue[i] = gun[r].currentShootTimer <= 0.0f;
+      if (volleyDue[i])
+        gun[r].currentShootTimer =
+            fmaxf(gun[r].currentShootTimer, -dt) + gun[r].shootCooldown;
+
+      SweptBox enemyBox = MakeSweptBox(enemyStart, position, ENEMY_SIZE);
+      for (const SweptShot &shot : playerShots) {
+        if (SweptBoxesOverlap(enemyBox, shot.box) &&
+            SweptCirclesTouch(shot.start, shot.end, enemyStart, position,
+                              ENEMY_SIZE + BULLET_RADIUS))
+          hits.push_back(shot.bullet);
+      }
+      // Contact is swept like the bullets and dealt as a rate, carrying
+      // the fraction over, so a run takes the same damage at any tick
+      if (player.playerShieldIsActive ||
+          !SweptBoxesOverlap(playerBox, enemyBox) ||
+          !SweptCirclesTouch(playerStart, player.position, enemyStart,
+                             position, PLAYER_SIZE + ENEMY_SIZE))
+        continue;
+      body[r].contactDamage += ENEMY_CONTACT_DPS * dt;
+      int damage = (int)body[r].contactDamage;
+      body[r].contactDamage -= damage;
+      if (damage > 0)
+        PushEvent({GameEventType::PLAYER_HIT, position, damage,
+                   NodeType::NONE, -1});
+    }
+  };
+  ParallelFor(enemies.GetCapacity(), ENEMY_CHUNK_SIZE,
+              [&](int begin, int end) {
+                enemies.ForRange(begin, end, update);
+              });
+
+  // Bullets are spent in enemy order, so each one goes to the same enemy
+  // and kills are queued in the same order as a single-threaded pass
+  int liveEnemies = 0;
+  enemies.ForEachAlive([&](int slot, EnemyBody &body, EnemyGun &) {
+    liveEnemies++;
+    for (int b : bulletHits[slot]) {
+      if (!bullets.IsAlive(b))
+        continue; // Already spent on an earlier enemy
+      int damage = bullets.Get<Projectile>(b).damage;
+      body.health -= damage;
+      stats.damageDealt += damage;
+      bullets.SetAlive(b, false);
+      if (body.health <= 0) {
+        enemies.SetAlive(slot, false);
+        freeEnemySlots.push_back(slot);
+        TRACE_INSTANT("enemy kill", slot);
+        liveEnemies--;
+        PushEvent({GameEventType::ENEMY_KILLED, body.position, 0,
+                   NodeType::NONE, -1});
+        break;
+      }
+      // Only the renderer cares about hits that don't kill
+      if (notifications)
+        PushEvent({GameEventType::ENEMY_HIT, bullets.Get<Motion>(b).position,
+                   damage, NodeType::NONE, -1});
+    }
+  });
+  return liveEnemies;
+}
+
+void GameWorld::FireEnemyVolleys() {
+  // One sweep of the pool serves every volley this tick
+  int freeSlot = 0;
+  for (int i = 0; i < enemies.GetCapacity(); i++) {
+    if (!volleyDue[i] || !enemies.IsAlive(i))
+      continue;
+
+    Vector2 origin = enemies.Get<EnemyBody>(i).position;
+    EnemyGun &gun = enemies.Get<EnemyGun>(i);
+    const BulletPattern &pattern = patterns[gun.pattern];
+    float aim = atan2f(player.position.y - origin.y,
+                       player.position.x - origin.x);
+    int count = EmitPattern(pattern, aim, gun.patternPhase,
+                            volleyVelocities.data(),
+                            (int)volleyVelocities.size());
+    gun.patternPhase = fmodf(gun.patternPhase + pattern.spin, 360.0f);
+
+    Color color = GetPatternColor(pattern.shape);
+    for (int shot = 0; shot < count; shot++) {
+      freeSlot = bullets.FindFree(freeSlot);
+      if (freeSlot == bullets.GetCapacity())
+        return; // Pool exhausted; the rest of this tick's volleys are lost
+      bullets.SetAlive(freeSlot, true);
+      bullets.Get<Motion>(freeSlot) = {origin, volleyVelocities[shot]};
+      bullets.Get<Projectile>(freeSlot) = {color, pattern.damage, false};
+    }
+  }
+}
+
+void GameWorld::DrainEvents() {
+  static const NodeType typesToDrop[] = {
+      NodeType::STAT_HEALTH,    NodeType::STAT_SPEED,
+      NodeType::STAT_DAMAGE,    NodeType::ACTION_FIRE,
+      NodeType::ACTION_SHIELD,  NodeType::ACTION_SHIFT,
+      NodeType::STAT_FIRE_RATE, NodeType::POWER_DURATION_REDUCE,
+      NodeType::POWER_VALUE_ADD};
+
+  // Drops queue follow-up events, which this same loop picks up
+  GameEvent event;
+  while (PopEvent(event)) {
+    if (notifications)
+      notifications->TryPush(event);
+    switch (event.type) {
+    case GameEventType::ENEMY_KILLED: {
+      stats.kills++;
+      NodeType dropped = typesToDrop[random.Range(
+          0, sizeof(typesToDrop) / sizeof(NodeType) - 1)];
+      player.AddInventoryNode(dropped);
+      PushEvent({GameEventType::NODE_DROPPED, event.position, 1, dropped,
+                 -1});
+      break;
+    }
+    case GameEventType::PLAYER_HIT:
+      player.currentHealth -= event.amount;
+      stats.damageTaken += event.amount;
+      if (player.currentHealth <= 0)
+        state = GameState::GAME_OVER;
+      break;
+    case GameEventType::ENEMY_HIT:
+    case GameEventType::NODE_DROPPED:
+      break;
+    case GameEventType::ACTION_STARTED:
+      stats.activations[(int)event.nodeType]++;
+      break;
+    }
+  }
+}
+
+void GameWorld::WriteSnapshot(RenderSnapshot &snapshot) const {
+  snapshot.tick = tickCount;
+  snapshot.state = state;
+
+  snapshot.playerPosition = player.position;
+  snapshot.playerShieldIsActive = player.playerShieldIsActive;
+  snapshot.currentHealth = player.currentHealth;
+  snapshot.maxHealth = player.maxHealth;
+  snapshot.currentSpeed = player.currentSpeed;
+  snapshot.currentDamage = player.currentDamage;
+  snapshot.currentFireRate = player.currentFireRate;
+
+  snapshot.activeActionNodeId = player.activeActionNodeId;
+  snapshot.activeActionIsEffect = false;
+  snapshot.activeActionTimer = nodesController.GetActionTimeLeft();
+  if (BaseNode *activeNode =
+          player.GetPlayerNodeById(player.activeActionNodeId))
+    snapshot.activeActionIsEffect = activeNode->isCurrentlyActiveEffect;
+
+  snapshot.bullets.clear();
+  bullets.ForEachAlive(
+      [&](int, const Motion &motion, const Projectile &projectile) {
+        snapshot.bullets.push_back({motion.position, projectile.color});
+      });
+
+  snapshot.enemies.clear();
+  enemies.ForEachAlive([&](int, const EnemyBody &body, const EnemyGun &) {
+    snapshot.enemies.push_back({body.position, body.health});
+  });
+
+  snapshot.inventoryCount = 0;
+  for (const InventoryStack &stack : player.inventoryStacks) {
+    if (snapshot.inventoryCount == MAX_INVENTORY_STACKS)
+      break;
+    snapshot.inventory[snapshot.inventoryCount++] = stack;
+  }
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "BulletPattern.h"
+#include "Collision.h"
+#include "Entities.h"
+#include "FlowField.h"
+#include "GameEvent.h"
+#include "GameRandom.h"
+#include "NodesController.h"
+#include "Player.h"
+#include "WaveDirector.h"
+#include "raylib.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class GameState { MAIN_MENU, GAMEPLAY, GAME_OVER };
+
+// Everything the simulation needs from the keyboard and mouse for one tick.
+// Gathered on the main thread, so the world never polls raylib input itself.
+struct PlayerInput {
+  Vector2 moveDir;     // Raw WASD axes, not normalised
+  Vector2 aimPosition; // Cursor in virtual screen coordinates
+  bool fireHeld;       // Left button held outside the control panel
+};
+
+// Running totals for the current run, reset by Init
+struct RunStats {
+  float elapsed;   // Seconds of gameplay ticked
+  int kills;
+  int damageDealt; // Player bullet damage that landed on enemies
+  int damageTaken;
+  int wave; // Waves started so far
+  int activations[NODE_TYPE_COUNT]; // Action starts, indexed by NodeType
+};
+
+class JobSystem;
+class Profiler;
+struct RenderSnapshot;
+
+// Gameplay state and the fixed-order tick that advances it. Owns no window
+// resources, so it can be ticked on any thread.
+class GameWorld {
+public:
+  GameState state;
+  Player player;
+  BulletStore bullets;
+  EnemyStore enemies;
+  NodesController nodesController;
+
+  GameWorld(int width, int height, int maxEnemies = MAX_ENEMIES,
+            int maxBullets = MAX_BULLETS);
+  ~GameWorld() = default;
+
+  // Disable copy and move operations
+  GameWorld(const GameWorld &) = delete;
+  GameWorld &operator=(const GameWorld &) = delete;
+  GameWorld(GameWorld &&) = delete;
+  GameWorld &operator=(GameWorld &&) = delete;
+
+  // Seeds the world's generator; call before Init to replay a run
+  void Seed(uint64_t seed) { random.Seed(seed); }
+  // Resizes the enemy pool and the event queue sized from it. Memory for
+  // the whole pool is reserved here, so spawning never allocates. Drops
+  // every enemy, so call it before Init and never while a tick can run.
+  void SetEnemyCapacity(int maxEnemies);
+  // Replaces every enemy slot at once and rebuilds the free list; for
+  // benchmarks that restore a fixed layout of the same capacity
+  void SetEnemies(const EnemyStore &layout);
+  void Init();
+  // Advances the world by dt when a run is in progress
+  void Tick(const PlayerInput &input, float dt);
+  void WriteSnapshot(RenderSnapshot &snapshot) const;
+
+  // Spreads the enemy and bullet passes over a job system. The result is
+  // bit-identical with or without one; nullptr runs them inline.
+  void SetJobSystem(JobSystem *jobs) { this->jobs = jobs; }
+  // Every applied event is forwarded here for the HUD and effects. Pushes
+  // never wait; when the consumer falls behind, notifications are dropped.
+  // nullptr disables.
+  void SetNotificationQueue(GameEventQueue *queue) { notifications = queue; }
+  // Times the tick phases; nullptr disables
+  void SetProfiler(Profiler *profiler) { this->profiler = profiler; }
+  // Volleys enemies pick from at spawn. Empty restores the built-in set.
+  void SetBulletPatterns(const std::vector<BulletPattern> &patterns);
+  // Waves and archetypes from a file (see WaveDirector.h). On failure the
+  // built-in waves stay.
+  bool LoadWaves(const std::string &path);
+  // Keeps the enemy pool full for stress runs (see WaveDirector::LoadEndless)
+  void SetEndlessWave() { waveDirector.LoadEndless(enemies.GetCapacity()); }
+  // Scales how often enemies spawned from now on fire; 1 plays as designed
+  void SetEnemyFireRate(float scale) { enemyFireRate = scale; }
+
+  int GetWidth() const { return width; }
+  int GetHeight() const { return height; }
+  unsigned long long GetTickCount() const { return tickCount; }
+  const RunStats &GetStats() const { return stats; }
+  // Inline size plus the capacity of the pools, queues and scratch arrays
+  // the world owns; the player's nodes are left out
+  size_t GetMemoryBytes() const;
+
+private:
+  int width;
+  int height;
+  unsigned long long tickCount;
+  JobSystem *jobs;
+  Profiler *profiler;
+  float enemyFireRate;
+  GameRandom random;
+  RunStats stats;
+  std::unique_ptr<GameEventQueue> events;
+  GameEventQueue *notifications;
+  // Events pushed while the queue was full, applied after it. Rare, so a
+  // lock is fine, and kept because every event changes the run.
+  std::mutex overflowMutex;
+  std::vector<GameEvent> overflowEvents;
+  size_t overflowRead;
+
+  // Per-enemy results of the parallel collision pass, reused every tick
+  std::vector<std::vector<int>> bulletHits;
+
+  // Live player shots in pool order, with their path this tick and its
+  // bounds for the broadphase
+  struct SweptShot {
+    int bullet;
+    Vector2 start;
+    Vector2 end;
+    SweptBox box;
+  };
+  std::vector<SweptShot> playerShots;
+  Vector2 playerStart; // Player position before this tick's move
+
+  // Steering: a heading field toward the player and a grid of live enemy
+  // positions for separation, both rebuilt serially before the pass
+  FlowField flowField;
+  SeparationGrid separation;
+  std::vector<Vector2> livePositions;
+  std::vector<int> liveIds;
+  std::vector<float> pushX; // Per grid entry, in the grid's sorted order
+  std::vector<float> pushY;
+  std::vector<float> steerX; // Per enemy slot: heading plus separation
+  std::vector<float> steerY;
+
+  // Enemy fire: shoot timers run in the parallel pass and flag the enemy,
+  // then the volleys are spawned serially in enemy order
+  std::vector<BulletPattern> patterns;
+  std::vector<unsigned char> volleyDue;
+  std::vector<Vector2> volleyVelocities;
+
+  // Spawning: the director picks how many, the free list picks the slots.
+  // Slots are pushed as enemies die and popped as they spawn.
+  WaveDirector waveDirector;
+  std::vector<int> archetypePatterns; // Pattern index per archetype
+  std::vector<int> freeEnemySlots;
+
+  void ParallelFor(int count, int chunkSize,
+                   const std::function<void(int, int)> &body);
+  void ResetEnemyPool();
+  void SpawnEnemy(const EnemyArchetype &archetype, int pattern,
+                  const WaveSpec &wave);
+  void SpawnWaves(float dt, int liveEnemies);
+  void ResolveArchetypePatterns();
+  void UpdatePlayer(const PlayerInput &input, float dt);
+  void UpdateBullets(float dt);
+  // Enemy bullets whose path this tick touched the player's: absorbed by
+  // the shield, otherwise queued as hits
+  void CollideHostileBullets(float dt);
+  // Returns how many enemies are still alive after the pass
+  int UpdateEnemies(float dt);
+  void FireEnemyVolleys();
+  void ResizeEventQueue();
+  void PushEvent(const GameEvent &event);
+  bool PopEvent(GameEvent &event);
+  void DrainEvents();
+};
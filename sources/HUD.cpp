@@ -1,46 +1,139 @@
 #include "HUD.h"
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 
-HUD::HUD() {}
+static const float NOTIFICATION_TIME = 2.0f;
 
-void HUD::DrawGameHUD(const Player &player, bool isPanelOpen, int screenWidth,
-                      int screenHeight) {
-  DrawPlayerStats(player);
-  DrawActiveAction(player, isPanelOpen, screenWidth);
-  DrawInstructions(screenHeight);
+static const char *INSTRUCTIONS_TEXT = "TAB for Panel";
+// Wide enough for any node name and timer at 20 px
+static const float ACTION_BANNER_WIDTH = 480.0f;
+
+HUD::HUD()
+    : notificationCount(0), layoutWidth(0), layoutHeight(0),
+      layoutPanelOpen(false), actionVisible(false) {}
+
+void HUD::AddNotification(const char *text, Color color) {
+  // The oldest drops off the end when full
+  int kept = notificationCount < MAX_NOTIFICATIONS ? notificationCount
+                                                   : MAX_NOTIFICATIONS - 1;
+  memmove(&notifications[1], &notifications[0],
+          kept * sizeof(Notification));
+  notificationCount = kept + 1;
+  Notification &notification = notifications[0];
+  snprintf(notification.text, sizeof(notification.text), "%s", text);
+  notification.color = color;
+  notification.timeLeft = NOTIFICATION_TIME;
+}
+
+void HUD::UpdateNotifications(float dt) {
+  for (int i = 0; i < notificationCount; i++)
+    notifications[i].timeLeft -= dt;
+  while (notificationCount > 0 &&
+         notifications[notificationCount - 1].timeLeft <= 0.0f)
+    notificationCount--;
 }
 
-void HUD::DrawPlayerStats(const Player &player) {
-  DrawText(TextFormat("Health: %d/%d", player.currentHealth, player.maxHealth),
-           10, 10, 20, RAYWHITE);
-  DrawText(TextFormat("Speed: %.0f", player.currentSpeed), 10, 30, 20,
+void HUD::Layout(int screenWidth, int screenHeight, bool isPanelOpen) {
+  layoutWidth = screenWidth;
+  layoutHeight = screenHeight;
+  layoutPanelOpen = isPanelOpen;
+
+  float gameAreaReferenceWidth = screenWidth;
+  if (isPanelOpen)
+    gameAreaReferenceWidth = screenWidth * 2.0f / 3.0f;
+  statsWidget.rect = {10, 10, 260, 80};
+  actionWidget.rect = {gameAreaReferenceWidth / 2.0f -
+                           ACTION_BANNER_WIDTH / 2.0f,
+                       10, ACTION_BANNER_WIDTH, 20};
+  instructionsWidget.rect = {10, (float)(screenHeight - 30),
+                             (float)MeasureText(INSTRUCTIONS_TEXT, 20), 20};
+  layer.Layout(screenWidth, screenHeight);
+}
+
+void HUD::PaintGameHUD(const RenderSnapshot &snapshot, const Player &player,
+                       bool isPanelOpen, int screenWidth, int screenHeight) {
+  if (screenWidth != layoutWidth || screenHeight != layoutHeight ||
+      isPanelOpen != layoutPanelOpen)
+    Layout(screenWidth, screenHeight, isPanelOpen);
+
+  UiKey statsKey;
+  statsKey.Add(snapshot.currentHealth)
+      .Add(snapshot.maxHealth)
+      .Add(snapshot.currentSpeed)
+      .Add(snapshot.currentDamage)
+      .Add(snapshot.currentFireRate);
+  if (layer.BeginRepaint(statsWidget, statsKey.Get())) {
+    DrawPlayerStats(snapshot);
+    layer.EndRepaint();
+  }
+
+  // The banner's key is its text, which changes every tenth of a second
+  const BaseNode *activeNode = nullptr;
+  if (snapshot.activeActionNodeId != -1 && snapshot.activeActionIsEffect)
+    activeNode = player.GetPlayerNodeById(snapshot.activeActionNodeId);
+  actionVisible = activeNode != nullptr;
+  const char *actionText = "";
+  if (activeNode)
+    actionText = TextFormat("ACTION: %s (%.1fs)", activeNode->name.c_str(),
+                            fmaxf(0.0f, snapshot.activeActionTimer));
+  Color actionColor = activeNode ? activeNode->color : BLANK;
+  UiKey actionKey;
+  actionKey.Add(actionText, strlen(actionText))
+      .Add(&actionColor, sizeof(actionColor));
+  if (layer.BeginRepaint(actionWidget, actionKey.Get())) {
+    DrawActiveAction(actionText, actionColor);
+    layer.EndRepaint();
+  }
+
+  if (layer.BeginRepaint(instructionsWidget, 0)) {
+    DrawInstructions();
+    layer.EndRepaint();
+  }
+}
+
+void HUD::DrawGameHUD() {
+  layer.Draw(statsWidget.rect);
+  if (actionVisible)
+    layer.Draw(actionWidget.rect);
+  DrawNotifications();
+  layer.Draw(instructionsWidget.rect);
+}
+
+void HUD::DrawNotifications() {
+  int y = 100;
+  for (int i = 0; i < notificationCount; i++) {
+    const Notification &notification = notifications[i];
+    // Fade out over the last half second
+    float alpha = fminf(1.0f, notification.timeLeft / 0.5f);
+    DrawText(notification.text, 10, y, 15,
+             ColorAlpha(notification.color, alpha));
+    y += 18;
+  }
+}
+
+void HUD::DrawPlayerStats(const RenderSnapshot &snapshot) {
+  DrawText(
+      TextFormat("Health: %d/%d", snapshot.currentHealth, snapshot.maxHealth),
+      10, 10, 20, RAYWHITE);
+  DrawText(TextFormat("Speed: %.0f", snapshot.currentSpeed), 10, 30, 20,
            RAYWHITE);
-  DrawText(TextFormat("Damage: %d", player.currentDamage), 10, 50, 20,
+  DrawText(TextFormat("Damage: %d", snapshot.currentDamage), 10, 50, 20,
            RAYWHITE);
-  DrawText(TextFormat("Fire Rate CD: %.2fs", player.currentFireRate), 10, 70,
+  DrawText(TextFormat("Fire Rate CD: %.2fs", snapshot.currentFireRate), 10, 70,
            20, RAYWHITE);
 }
 
-void HUD::DrawActiveAction(const Player &player, bool isPanelOpen,
-                           int screenWidth) {
-  if (player.activeActionNodeId != -1) {
-    BaseNode *activeNode = player.GetPlayerNodeById(player.activeActionNodeId);
-    if (activeNode && activeNode->isCurrentlyActiveEffect) {
-      const char *text =
-          TextFormat("ACTION: %s (%.1fs)", activeNode->name.c_str(),
-                     fmaxf(0.0f, activeNode->currentActiveTimer));
-      int textWidth = MeasureText(text, 20);
-      float gameAreaReferenceWidth = screenWidth;
-      if (isPanelOpen)
-        gameAreaReferenceWidth = screenWidth * 2.0f / 3.0f;
-      DrawText(text, (int)(gameAreaReferenceWidth / 2.0f - textWidth / 2.0f),
-               10, 20, activeNode->color);
-    }
-  }
+void HUD::DrawActiveAction(const char *text, Color color) {
+  if (text[0] == '\0')
+    return;
+  int textWidth = MeasureText(text, 20);
+  float center = actionWidget.rect.x + actionWidget.rect.width / 2.0f;
+  DrawText(text, (int)(center - textWidth / 2.0f), 10, 20, color);
 }
 
-void HUD::DrawInstructions(int screenHeight) {
-  DrawText("TAB for Panel", 10, screenHeight - 30, 20, RAYWHITE);
+void HUD::DrawInstructions() {
+  DrawText(INSTRUCTIONS_TEXT, 10, layoutHeight - 30, 20, RAYWHITE);
 }
 
 void HUD::DrawMainMenu(int screenWidth, int screenHeight) {
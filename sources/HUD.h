@@ -1,19 +1,56 @@
 #pragma once
 #include "Player.h"
+#include "RenderSnapshot.h"
+#include "UiLayer.h"
 
 class HUD {
 public:
   HUD();
   ~HUD() = default;
 
-  void DrawGameHUD(const Player &player, bool isPanelOpen, int screenWidth,
-                   int screenHeight);
+  // Repaints the cached stats, action banner and hints where their values
+  // changed; call before the overlay pass. Dynamic values come from the
+  // snapshot; player is only used to look up the active node's name and
+  // colour.
+  void PaintGameHUD(const RenderSnapshot &snapshot, const Player &player,
+                    bool isPanelOpen, int screenWidth, int screenHeight);
+  void DrawGameHUD();
+  void Unload() { layer.Unload(); }
+  // Off paints straight to the overlay; see UiLayer
+  void SetCached(bool cache) { layer.SetCached(cache); }
   void DrawMainMenu(int screenWidth, int screenHeight);
+
+  // Short-lived messages under the stats, newest first. Long text is cut.
+  void AddNotification(const char *text, Color color);
+  void UpdateNotifications(float dt);
   void DrawGameOver(int screenWidth, int screenHeight);
 
 private:
-  void DrawPlayerStats(const Player &player);
-  void DrawActiveAction(const Player &player, bool isPanelOpen,
-                        int screenWidth);
-  void DrawInstructions(int screenHeight);
+  // A drop notice arrives with most kills, so the messages live in a fixed
+  // array and adding one never allocates
+  static const int MAX_NOTIFICATIONS = 5;
+  struct Notification {
+    char text[96];
+    Color color;
+    float timeLeft;
+  };
+  Notification notifications[MAX_NOTIFICATIONS]; // Newest first
+  int notificationCount;
+
+  // Laid out for this screen size and panel state
+  UiLayer layer;
+  UiWidget statsWidget;
+  UiWidget actionWidget;
+  UiWidget instructionsWidget;
+  int layoutWidth;
+  int layoutHeight;
+  bool layoutPanelOpen;
+  bool actionVisible;
+
+  void Layout(int screenWidth, int screenHeight, bool isPanelOpen);
+  void DrawPlayerStats(const RenderSnapshot &snapshot);
+  void DrawActiveAction(const char *text, Color color);
+  void DrawInstructions();
+  // Fading every frame, so drawn directly rather than cached
+  void DrawNotifications();
 };
@@ -0,0 +1,129 @@
+#include "JobSystem.h"
+#include "Tracer.h"
+#include <algorithm>
+
+JobSystem::JobSystem(int workerCount)
+    : queuedJobs(0), unfinishedJobs(0), stopping(false) {
+  StartWorkers(workerCount);
+}
+
+JobSystem::~JobSystem() { StopWorkers(); }
+
+void JobSystem::SetWorkerCount(int workerCount) {
+  StopWorkers();
+  StartWorkers(workerCount);
+}
+
+void JobSystem::StartWorkers(int workerCount) {
+  if (workerCount <= 0)
+    workerCount = std::max(1, (int)std::thread::hardware_concurrency());
+
+  stopping = false;
+  for (int i = 0; i < workerCount; i++)
+    queues.push_back(std::make_unique<WorkQueue>());
+  for (int i = 1; i < workerCount; i++)
+    workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+void JobSystem::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    stopping = true;
+  }
+  wakeCondition.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+  workers.clear();
+  queues.clear();
+}
+
+void JobSystem::ParallelFor(int count, int chunkSize,
+                            const std::function<void(int, int)> &body) {
+  if (count <= 0)
+    return;
+  chunkSize = std::max(1, chunkSize);
+  if (queues.size() == 1 || count <= chunkSize) {
+    body(0, count);
+    return;
+  }
+
+  // Deal the chunks out round-robin, starting with the caller's own queue
+  int chunkCount = (count + chunkSize - 1) / chunkSize;
+  unfinishedJobs.store(chunkCount);
+  for (int chunk = 0; chunk < chunkCount; chunk++) {
+    int begin = chunk * chunkSize;
+    WorkQueue &queue = *queues[chunk % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back({&body, begin, std::min(count, begin + chunkSize)});
+  }
+  queuedJobs.fetch_add(chunkCount);
+
+  // Taking the lock orders the push before any worker's sleep check
+  { std::lock_guard<std::mutex> lock(wakeMutex); }
+  wakeCondition.notify_all();
+
+  // Help out until the last chunk finishes, even if it's someone else's
+  Job job;
+  while (unfinishedJobs.load() > 0) {
+    if (TryGetJob(0, job))
+      RunJob(job);
+    else
+      std::this_thread::yield();
+  }
+}
+
+void JobSystem::WorkerLoop(int queueIndex) {
+  TRACE_THREAD_NAME("job worker");
+  Job job;
+  while (true) {
+    if (TryGetJob(queueIndex, job)) {
+      RunJob(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeCondition.wait(lock,
+                       [this] { return stopping || queuedJobs.load() > 0; });
+    if (stopping)
+      return;
+  }
+}
+
+bool JobSystem::TryGetJob(int queueIndex, Job &job) {
+  if (queuedJobs.load() == 0)
+    return false;
+
+  // Own queue first, newest job, which is the one most likely still in cache
+  {
+    WorkQueue &own = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = own.jobs.back();
+      own.jobs.pop_back();
+      queuedJobs.fetch_sub(1);
+      return true;
+    }
+  }
+
+  // Then steal the oldest job from the others
+  int queueCount = (int)queues.size();
+  for (int offset = 1; offset < queueCount; offset++) {
+    WorkQueue &victim = *queues[(queueIndex + offset) % queueCount];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = victim.jobs.front();
+      victim.jobs.pop_front();
+      queuedJobs.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::RunJob(const Job &job) {
+  {
+    TRACE_SCOPE("job");
+    (*job.body)(job.begin, job.end);
+  }
+  unfinishedJobs.fetch_sub(1);
+}
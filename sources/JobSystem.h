@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing thread pool for data-parallel loops. Every participant
+// (the calling thread plus the workers) owns a deque: it pops its own jobs
+// from the back and steals from the front of the others when it runs dry.
+//
+// ParallelFor may only be called from one thread at a time and not from
+// inside a job.
+class JobSystem {
+public:
+  // workerCount counts the calling thread, so 1 runs everything inline.
+  // 0 picks one per hardware thread.
+  explicit JobSystem(int workerCount = 1);
+  ~JobSystem();
+
+  // Disable copy and move operations
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+  JobSystem(JobSystem &&) = delete;
+  JobSystem &operator=(JobSystem &&) = delete;
+
+  void SetWorkerCount(int workerCount);
+  int GetWorkerCount() const { return (int)queues.size(); }
+
+  // Calls body(begin, end) over [0, count) in chunks of at most chunkSize
+  // and returns once every chunk has run. Chunks may run in any order, so
+  // the body must only write state owned by its own range.
+  void ParallelFor(int count, int chunkSize,
+                   const std::function<void(int, int)> &body);
+
+private:
+  struct Job {
+    const std::function<void(int, int)> *body;
+    int begin;
+    int end;
+  };
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> queues; // [0] is the caller's
+  std::vector<std::thread> workers;
+
+  std::atomic<int> queuedJobs;
+  std::atomic<int> unfinishedJobs;
+  std::mutex wakeMutex;
+  std::condition_variable wakeCondition;
+  bool stopping;
+
+  void StartWorkers(int workerCount);
+  void StopWorkers();
+  void WorkerLoop(int queueIndex);
+  bool TryGetJob(int queueIndex, Job &job);
+  void RunJob(const Job &job);
+};
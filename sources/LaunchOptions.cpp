@@ -0,0 +1,169 @@
+#include "LaunchOptions.h"
+#include "GameWorld.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+void PrintLaunchUsage(const char *program) {
+  printf("usage: %s [options]\n\n", program);
+  printf("  --pacing=MODE         capped, uncapped, vsync or low-latency\n");
+  printf("  --fps=N               target frame rate for capped mode (60)\n");
+  printf("  --frame-stats=PATH    write frame-time histograms on exit "
+         "('-' for stdout)\n");
+  printf("  --workers=N           job system threads for the tick, "
+         "including its own (auto)\n");
+  printf("  --no-sim-thread       run the simulation tick on the main "
+         "thread\n");
+  printf("  --enemies=N           enemy pool size (%d)\n", MAX_ENEMIES);
+  printf("  --trace=PATH          record a Chrome trace from launch, written "
+         "on exit\n");
+  printf("  --no-ui-cache         draw the HUD and panel directly every "
+         "frame\n");
+  printf("  --alloc-sample=N      sample the callstack of 1 in N allocations, "
+         "top sites\n");
+  printf("                        printed on exit (RRL_ALLOC_TRACKING "
+         "builds)\n");
+  printf("  --help                show this message\n\n");
+  printf("headless batch mode:\n");
+  printf("  --batch=PATH          play runs of the build in PATH without a "
+         "window\n");
+  printf("  --runs=N              number of runs (1000)\n");
+  printf("  --seed=N              seed of the first run, then +1 per run "
+         "(1)\n");
+  printf("  --duration=S          cut runs off after S seconds (from the "
+         "build)\n");
+  printf("  --tick-rate=HZ        simulation steps per second (60)\n");
+  printf("  --out=PATH            CSV results ('-' for stdout, default)\n\n");
+  printf("stress scenario:\n");
+  printf("  --stress              start in gameplay with the panel open, keep "
+         "the enemy\n");
+  printf("                        pool full, print frame stats and exit\n");
+  printf("  --stress-duration=S   seconds before exiting, 0 to run until "
+         "closed (60)\n");
+  printf("  --bullet-rate=X       enemy fire rate multiplier (1)\n");
+  printf("  --no-auto-fire        leave firing to the player and the node "
+         "graph\n");
+  printf("  --random-nodes=N      place N random nodes with random links "
+         "(0)\n\n");
+  printf("build search:\n");
+  printf("  --suggest=PATH        search wirings of the nodes in PATH and "
+         "write the best\n");
+  printf("                        build to --out\n");
+  printf("  --beam=N              wirings kept per search step (4)\n");
+}
+
+// Matches "--name=value" and returns the value part
+static const char *OptionValue(const char *arg, const char *name) {
+  size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 && arg[length] == '=')
+    return arg + length + 1;
+  return nullptr;
+}
+
+bool ParseLaunchOptions(int argc, char **argv, LaunchOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value;
+
+    if (strcmp(arg, "--help") == 0) {
+      PrintLaunchUsage(argv[0]);
+      return false;
+    } else if ((value = OptionValue(arg, "--pacing"))) {
+      if (!ParsePacingMode(value, options.pacingMode)) {
+        fprintf(stderr, "unknown pacing mode '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--fps"))) {
+      options.targetFps = atoi(value);
+      if (options.targetFps < 0) {
+        fprintf(stderr, "invalid frame rate '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--frame-stats"))) {
+      options.frameStatsPath = value;
+    } else if ((value = OptionValue(arg, "--workers"))) {
+      options.workerCount = atoi(value);
+      if (options.workerCount <= 0) {
+        fprintf(stderr, "invalid worker count '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--enemies"))) {
+      options.enemyCapacity = atoi(value);
+      if (options.enemyCapacity <= 0) {
+        fprintf(stderr, "invalid enemy count '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--trace"))) {
+      options.tracePath = value;
+    } else if ((value = OptionValue(arg, "--alloc-sample"))) {
+      options.allocSampleInterval = atoi(value);
+      if (options.allocSampleInterval <= 0) {
+        fprintf(stderr, "invalid sample interval '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--batch"))) {
+      options.batch.buildPath = value;
+    } else if ((value = OptionValue(arg, "--runs"))) {
+      options.batch.runs = atoi(value);
+      if (options.batch.runs <= 0) {
+        fprintf(stderr, "invalid run count '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--seed"))) {
+      options.batch.firstSeed = strtoull(value, nullptr, 10);
+    } else if ((value = OptionValue(arg, "--duration"))) {
+      options.batch.duration = (float)atof(value);
+      if (options.batch.duration <= 0.0f) {
+        fprintf(stderr, "invalid duration '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--tick-rate"))) {
+      options.batch.tickRate = atoi(value);
+      if (options.batch.tickRate <= 0) {
+        fprintf(stderr, "invalid tick rate '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--suggest"))) {
+      options.suggestPath = value;
+    } else if ((value = OptionValue(arg, "--beam"))) {
+      options.search.beamWidth = atoi(value);
+      if (options.search.beamWidth <= 0) {
+        fprintf(stderr, "invalid beam width '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--out"))) {
+      options.batch.outputPath = value;
+    } else if (strcmp(arg, "--stress") == 0) {
+      options.stress.enabled = true;
+    } else if ((value = OptionValue(arg, "--stress-duration"))) {
+      options.stress.duration = (float)atof(value);
+      if (options.stress.duration < 0.0f) {
+        fprintf(stderr, "invalid stress duration '%s'\n", value);
+        return false;
+      }
+    } else if ((value = OptionValue(arg, "--bullet-rate"))) {
+      options.stress.bulletRate = (float)atof(value);
+      if (options.stress.bulletRate <= 0.0f) {
+        fprintf(stderr, "invalid bullet rate '%s'\n", value);
+        return false;
+      }
+    } else if (strcmp(arg, "--no-auto-fire") == 0) {
+      options.stress.autoFire = false;
+    } else if ((value = OptionValue(arg, "--random-nodes"))) {
+      options.stress.randomNodes = atoi(value);
+      if (options.stress.randomNodes < 0) {
+        fprintf(stderr, "invalid node count '%s'\n", value);
+        return false;
+      }
+    } else if (strcmp(arg, "--no-sim-thread") == 0) {
+      options.simulationThread = false;
+    } else if (strcmp(arg, "--no-ui-cache") == 0) {
+      options.uiCache = false;
+    } else {
+      fprintf(stderr, "unknown option '%s'\n", arg);
+      PrintLaunchUsage(argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "BatchRunner.h"
+#include "BuildSearch.h"
+#include "FramePacer.h"
+#include "StressScenario.h"
+#include <string>
+
+// Command-line configuration for the game executable
+struct LaunchOptions {
+  PacingMode pacingMode = PacingMode::CAPPED;
+  int targetFps = 60;
+  std::string frameStatsPath; // Histogram dump on exit, empty to skip
+  bool simulationThread = true; // Tick the world off the main thread
+  int workerCount = 0;          // Job system threads, 0 for one per spare core
+  int enemyCapacity = 0;        // Enemy pool size, 0 for MAX_ENEMIES
+  std::string tracePath; // Record a trace from launch, written here on exit
+  int allocSampleInterval = 0; // Callstack of 1 in N allocations, 0 for none
+  bool uiCache = true; // HUD and panel repaint into cached layers
+
+  // Headless batch mode, taken when batch.buildPath is set
+  BatchOptions batch;
+
+  // Scripted load in the windowed game, taken when stress.enabled is set.
+  // Shares --seed with batch mode.
+  StressOptions stress;
+
+  // Build search mode, taken when suggestPath is set. Shares --seed,
+  // --duration (per evaluation run) and --out with batch mode.
+  std::string suggestPath;
+  SearchOptions search;
+};
+
+// Returns false (after printing usage) on unknown or malformed arguments
+bool ParseLaunchOptions(int argc, char **argv, LaunchOptions &options);
+void PrintLaunchUsage(const char *program);
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free queue for many producer threads and one consumer. Each
+// slot carries a sequence number: a producer claims a position with one
+// compare-exchange on the tail and publishes the slot by bumping its
+// sequence, and the consumer reads slots in position order as they become
+// ready. TryPush never blocks; it returns false when the ring is full.
+template <typename T> class MpscQueue {
+public:
+  // capacity is rounded up to a power of two
+  explicit MpscQueue(size_t capacity) : head(0), tail(0) {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    mask = size - 1;
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; i++)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  // Disable copy and move operations
+  MpscQueue(const MpscQueue &) = delete;
+  MpscQueue &operator=(const MpscQueue &) = delete;
+  MpscQueue(MpscQueue &&) = delete;
+  MpscQueue &operator=(MpscQueue &&) = delete;
+
+  // Any thread
+  bool TryPush(const T &value) {
+    size_t position = tail.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = slots[position & mask];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+      if (difference == 0) {
+        if (tail.compare_exchange_weak(position, position + 1,
+                                       std::memory_order_relaxed)) {
+          slot.value = value;
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false; // The consumer hasn't freed this slot yet
+      } else {
+        position = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Consumer thread only. Stops at the first claimed but unpublished slot,
+  // so events come out in the order positions were claimed.
+  bool TryPop(T &value) {
+    Slot &slot = slots[head & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+      return false;
+    value = slot.value;
+    slot.sequence.store(head + mask + 1, std::memory_order_release);
+    head++;
+    return true;
+  }
+
+  size_t GetCapacity() const { return mask + 1; }
+  size_t GetMemoryBytes() const { return GetCapacity() * sizeof(Slot); }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Slot[]> slots;
+  size_t mask;
+  size_t head; // Consumer only
+  alignas(64) std::atomic<size_t> tail;
+};
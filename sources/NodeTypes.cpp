@@ -13,10 +13,7 @@ CPUCoreNode::CPUCoreNode(int _id, float _val, float _dur)
 
 void CPUCoreNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                        float rotation = 1.0f) {
-  const NPatchInfo *nPatchInfo = spriteManager.GetNPatchInfo();
-  NPatchInfo info = nPatchInfo[(int)SpriteType::CPU];
-  DrawTextureNPatch(spriteManager.GetSpritesheet(), info, dest, {0, 0},
-                    rotation, RAYWHITE);
+  spriteManager.DrawSprite("cpu", dest, rotation, RAYWHITE);
 };
 
 // HealthStatNode
@@ -29,9 +26,7 @@ HealthStatNode::HealthStatNode(int _id, float _val, float _dur)
 
 void HealthStatNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                           float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::GREEN_CYLINDER],
-                 dest, (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("green_cylinder", dest, rotation, RAYWHITE);
 }
 
 // SpeedStatNode
@@ -44,9 +39,7 @@ SpeedStatNode::SpeedStatNode(int _id, float _val, float _dur)
 
 void SpeedStatNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                          float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::BROWN_CYLINDER],
-                 dest, (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("brown_cylinder", dest, rotation, RAYWHITE);
 }
 
 // DamageStatNode
@@ -59,9 +52,7 @@ DamageStatNode::DamageStatNode(int _id, float _val, float _dur)
 
 void DamageStatNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                           float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::RED_CYLINDER],
-                 dest, (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("red_cylinder", dest, rotation, RAYWHITE);
 }
 
 // FireRateStatNode
@@ -74,9 +65,7 @@ FireRateStatNode::FireRateStatNode(int _id, float _val, float _dur)
 
 void FireRateStatNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                             float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::BROWN_CYLINDER],
-                 dest, (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("brown_cylinder", dest, rotation, RAYWHITE);
 }
 
 // FireActionNode
@@ -89,12 +78,7 @@ FireActionNode::FireActionNode(int _id, float _val, float _dur)
 
 void FireActionNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                           float rotation = 0.0f) {
-  const NPatchInfo *nPatchInfo = spriteManager.GetNPatchInfo();
-  const NPatchInfo info = nPatchInfo[(int)SpriteType::ACTION_CHIP];
-  const Texture2D spritesheet = spriteManager.GetSpritesheet();
-  DrawTextureNPatch(spritesheet,
-                    {{33, 3, 30, 26}, 8, 4, 2, 1, NPATCH_NINE_PATCH}, dest,
-                    {0, 0}, rotation, WHITE);
+  spriteManager.DrawSprite("fire_chip", dest, rotation, WHITE);
 };
 
 // ShieldActionNode
@@ -107,10 +91,7 @@ ShieldActionNode::ShieldActionNode(int _id, float _val, float _dur)
 
 void ShieldActionNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                             float rotation = 1.0f) {
-  const NPatchInfo *nPatchInfo = spriteManager.GetNPatchInfo();
-  NPatchInfo info = nPatchInfo[(int)SpriteType::ACTION_CHIP];
-  DrawTextureNPatch(spriteManager.GetSpritesheet(), info, dest, {0, 0},
-                    rotation, BLUE);
+  spriteManager.DrawSprite("action_chip", dest, rotation, BLUE);
 };
 
 // ShiftActionNode
@@ -123,10 +104,20 @@ ShiftActionNode::ShiftActionNode(int _id, float _val, float _dur)
 
 void ShiftActionNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                            float rotation = 1.0f) {
-  const NPatchInfo *nPatchInfo = spriteManager.GetNPatchInfo();
-  NPatchInfo info = nPatchInfo[(int)SpriteType::ACTION_CHIP];
-  DrawTextureNPatch(spriteManager.GetSpritesheet(), info, dest, {0, 0},
-                    rotation, MAGENTA);
+  spriteManager.DrawSprite("action_chip", dest, rotation, MAGENTA);
+};
+
+// BurstActionNode
+BurstActionNode::BurstActionNode(int _id, float _val, float _dur)
+    : BaseNode(_id, NodeType::ACTION_BURST, NodeKind::ACTION, "Burst Fire",
+               _val, _dur) {
+  color = GOLD;
+  description = "Action: Burst Fire. Several smaller blasts.";
+}
+
+void BurstActionNode::Draw(SpriteManager &spriteManager, Rectangle dest,
+                           float rotation = 0.0f) {
+  spriteManager.DrawSprite("fire_chip", dest, rotation, YELLOW);
 };
 
 // DurationReducePowerNode
@@ -142,9 +133,7 @@ DurationReducePowerNode::DurationReducePowerNode(int _id, float _val,
 
 void DurationReducePowerNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                                    float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::BLUE_LAMP], dest,
-                 (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("blue_lamp", dest, rotation, RAYWHITE);
 }
 
 // ValueAddPowerNode
@@ -159,7 +148,5 @@ ValueAddPowerNode::ValueAddPowerNode(int _id, float _val, float _dur)
 
 void ValueAddPowerNode::Draw(SpriteManager &spriteManager, Rectangle dest,
                              float rotation = 1.0f) {
-  DrawTexturePro(spriteManager.GetSpritesheet(),
-                 spriteManager.GetSprites()[(int)SpriteType::RED_LAMP], dest,
-                 (Vector2){0, 0}, rotation, RAYWHITE);
+  spriteManager.DrawSprite("red_lamp", dest, rotation, RAYWHITE);
 }
@@ -57,6 +57,16 @@ public:
             float rotation) override;
 };
 
+// Fires BURST_SHOTS blasts spread evenly over its duration
+const int BURST_SHOTS = 5;
+
+class BurstActionNode : public BaseNode {
+public:
+  BurstActionNode(int _id = -1, float _val = 6.0f, float _dur = 1.0f);
+  void Draw(SpriteManager &spriteManager, Rectangle dest,
+            float rotation) override;
+};
+
 class DurationReducePowerNode : public BaseNode {
 public:
   DurationReducePowerNode(int _id = -1, float _val = -0.5f, float _dur = 0.0f);
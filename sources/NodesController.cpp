@@ -1,26 +1,20 @@
 #include "NodesController.h"
 #include "BaseNode.h"
 #include "NodeTypes.h"
+#include "Tracer.h"
 #include "raymath.h"
+#include <algorithm>
 #include <cmath>
 
-struct Bullet {
-  Vector2 position;
-  Vector2 velocity;
-  bool active;
-  Color color;
-  int damage;
-  bool fromPlayer;
-};
-
-const int BULLET_SPEED = 800;
-const int MAX_BULLETS = 50;
-
-NodesController::NodesController() : nextNodeId(0) {}
+NodesController::NodesController()
+    : nextNodeId(0), events(nullptr), activeAction(-1),
+      activeActionEndsAt(0.0) {}
 
 void NodesController::Initialize() {
   InitNodeTemplates();
   nextNodeId = 0;
+  actionScheduler.Clear();
+  activeAction = -1;
 }
 
 void NodesController::InitNodeTemplates() {
@@ -35,6 +29,7 @@ void NodesController::InitNodeTemplates() {
   nodeTemplates[NodeType::ACTION_SHIELD] =
       std::make_unique<ShieldActionNode>(0);
   nodeTemplates[NodeType::ACTION_SHIFT] = std::make_unique<ShiftActionNode>(0);
+  nodeTemplates[NodeType::ACTION_BURST] = std::make_unique<BurstActionNode>(0);
   nodeTemplates[NodeType::POWER_DURATION_REDUCE] =
       std::make_unique<DurationReducePowerNode>(0);
   nodeTemplates[NodeType::POWER_VALUE_ADD] =
@@ -61,6 +56,8 @@ NodesController::CreateNodeFromTemplate(NodeType type) {
       return std::make_unique<ShieldActionNode>(nextNodeId++);
     case NodeType::ACTION_SHIFT:
       return std::make_unique<ShiftActionNode>(nextNodeId++);
+    case NodeType::ACTION_BURST:
+      return std::make_unique<BurstActionNode>(nextNodeId++);
     case NodeType::POWER_DURATION_REDUCE:
       return std::make_unique<DurationReducePowerNode>(nextNodeId++);
     case NodeType::POWER_VALUE_ADD:
@@ -72,6 +69,11 @@ NodesController::CreateNodeFromTemplate(NodeType type) {
   return std::make_unique<CPUCoreNode>(nextNodeId++); // Default fallback
 }
 
+BaseNode *NodesController::GetTemplate(NodeType type) const {
+  auto it = nodeTemplates.find(type);
+  return it != nodeTemplates.end() ? it->second.get() : nullptr;
+}
+
 BaseNode *
 NodesController::GetNodeById(int id,
                              std::vector<std::unique_ptr<BaseNode>> &nodes) {
@@ -107,8 +109,138 @@ void NodesController::UpdateNodeActivation(Player &player) {
   player.applyNodeEffects();
 }
 
-void NodesController::UpdateActionSystem(Player &player, Bullet bullets[],
-                                         float dt) {
+bool NodesController::ConnectNodes(Player &player, int fromId, int toId) {
+  BaseNode *fromNode = player.GetPlayerNodeById(fromId);
+  BaseNode *toNode = player.GetPlayerNodeById(toId);
+  if (!fromNode || !toNode || fromNode->id == toNode->id)
+    return false;
+
+  bool connectionChanged = false;
+
+  // CPU Core connection rules
+  if (fromNode->getNodeType() == NodeType::CPU_CORE) {
+    if (toNode->getNodeKind() == NodeKind::STAT ||
+        toNode->getNodeKind() == NodeKind::POWER ||
+        toNode->getNodeKind() == NodeKind::ACTION) {
+
+      // Special rule: CPU can only connect to one ACTION at a time
+      if (toNode->getNodeKind() == NodeKind::ACTION) {
+        // Remove existing ACTION connections
+        for (size_t i = 0; i < fromNode->connectedToNodeIDs.size();) {
+          BaseNode *existingTarget =
+              player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
+          if (existingTarget &&
+              existingTarget->getNodeKind() == NodeKind::ACTION &&
+              existingTarget->id != toNode->id) {
+            // Remove bidirectional connection
+            existingTarget->connectedFromNodeIDs.erase(
+                std::remove(existingTarget->connectedFromNodeIDs.begin(),
+                            existingTarget->connectedFromNodeIDs.end(),
+                            fromNode->id),
+                existingTarget->connectedFromNodeIDs.end());
+            fromNode->connectedToNodeIDs.erase(
+                fromNode->connectedToNodeIDs.begin() + i);
+            connectionChanged = true;
+          } else {
+            i++;
+          }
+        }
+      }
+
+      // Add new connection if not already connected
+      if (std::find(fromNode->connectedToNodeIDs.begin(),
+                    fromNode->connectedToNodeIDs.end(),
+                    toNode->id) ==
+          fromNode->connectedToNodeIDs.end()) {
+        fromNode->connectedToNodeIDs.push_back(toNode->id);
+        toNode->connectedFromNodeIDs.push_back(fromNode->id);
+        connectionChanged = true;
+      }
+    }
+  }
+  // ACTION to ACTION sequence connections
+  else if (fromNode->getNodeKind() == NodeKind::ACTION &&
+           toNode->getNodeKind() == NodeKind::ACTION) {
+    // Remove existing ACTION connections from this node
+    for (size_t i = 0; i < fromNode->connectedToNodeIDs.size();) {
+      BaseNode *existingTarget =
+          player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
+      if (existingTarget &&
+          existingTarget->getNodeKind() == NodeKind::ACTION &&
+          existingTarget->id != toNode->id) {
+        existingTarget->connectedFromNodeIDs.erase(
+            std::remove(existingTarget->connectedFromNodeIDs.begin(),
+                        existingTarget->connectedFromNodeIDs.end(),
+                        fromNode->id),
+            existingTarget->connectedFromNodeIDs.end());
+        fromNode->connectedToNodeIDs.erase(
+            fromNode->connectedToNodeIDs.begin() + i);
+        connectionChanged = true;
+      } else {
+        i++;
+      }
+    }
+
+    // Add new connection
+    if (std::find(fromNode->connectedToNodeIDs.begin(),
+                  fromNode->connectedToNodeIDs.end(),
+                  toNode->id) ==
+        fromNode->connectedToNodeIDs.end()) {
+      fromNode->connectedToNodeIDs.push_back(toNode->id);
+      toNode->connectedFromNodeIDs.push_back(fromNode->id);
+      connectionChanged = true;
+    }
+  }
+  // STAT to ACTION buff connections
+  else if (fromNode->getNodeKind() == NodeKind::STAT &&
+           toNode->getNodeKind() == NodeKind::ACTION) {
+    if (std::find(fromNode->connectedToNodeIDs.begin(),
+                  fromNode->connectedToNodeIDs.end(),
+                  toNode->id) ==
+        fromNode->connectedToNodeIDs.end()) {
+      fromNode->connectedToNodeIDs.push_back(toNode->id);
+      toNode->connectedFromNodeIDs.push_back(fromNode->id);
+      connectionChanged = true;
+    }
+  }
+  // POWER to STAT/ACTION modifier connections
+  else if (fromNode->getNodeKind() == NodeKind::POWER &&
+           (toNode->getNodeKind() == NodeKind::ACTION ||
+            toNode->getNodeKind() == NodeKind::STAT)) {
+    // Remove existing POWER connections (POWER nodes can only connect to
+    // one target)
+    for (size_t i = 0; i < fromNode->connectedToNodeIDs.size(); i++) {
+      BaseNode *existingTarget =
+          player.GetPlayerNodeById(fromNode->connectedToNodeIDs[i]);
+      if (existingTarget) {
+        existingTarget->connectedFromNodeIDs.erase(
+            std::remove(existingTarget->connectedFromNodeIDs.begin(),
+                        existingTarget->connectedFromNodeIDs.end(),
+                        fromNode->id),
+            existingTarget->connectedFromNodeIDs.end());
+      }
+    }
+    fromNode->connectedToNodeIDs.clear();
+
+    // Add new connection
+    fromNode->connectedToNodeIDs.push_back(toNode->id);
+    toNode->connectedFromNodeIDs.push_back(fromNode->id);
+    connectionChanged = true;
+  }
+
+  // Restart the sequence from the core on the next tick
+  if (connectionChanged)
+    CancelAction(player);
+  return connectionChanged;
+}
+
+void NodesController::UpdateActionSystem(Player &player, BulletStore &bullets,
+                                         Vector2 aimPosition, float dt) {
+  // Only actions whose wait is over run; the rest cost nothing
+  actionScheduler.Advance(dt, [&](ActionTask &task) {
+    return ResumeAction(player, bullets, aimPosition, task);
+  });
+
   if (player.activeActionNodeId == -1) {
     // Start new action sequence
     BaseNode *cpuNode = player.GetPlayerNodeById(0);
@@ -117,75 +249,120 @@ void NodesController::UpdateActionSystem(Player &player, Bullet bullets[],
         BaseNode *potentialStartNode = player.GetPlayerNodeById(connectedId);
         if (potentialStartNode &&
             potentialStartNode->getNodeKind() == NodeKind::ACTION) {
-          player.activeActionNodeId = potentialStartNode->id;
-          StartNewAction(player, bullets, potentialStartNode);
+          StartAction(player, bullets, potentialStartNode, aimPosition);
           break;
         }
       }
     }
-  } else {
-    ProcessActionSequence(player, bullets, dt);
-  }
-}
-
-void NodesController::ProcessActionSequence(Player &player, Bullet bullets[],
-                                            float dt) {
-  BaseNode *currentActionNode =
-      player.GetPlayerNodeById(player.activeActionNodeId);
-  if (currentActionNode) {
-    if (currentActionNode->currentActiveTimer > 0) {
-      currentActionNode->currentActiveTimer -= dt;
-      if (currentActionNode->getNodeType() == NodeType::ACTION_SHIELD)
-        player.playerShieldIsActive = true;
-    } else {
-      // Action finished, find next action or restart
-      currentActionNode->isCurrentlyActiveEffect = false;
-      if (currentActionNode->getNodeType() == NodeType::ACTION_SHIELD)
-        player.playerShieldIsActive = false;
-
-      int nextNodeInSequenceId = -1;
-      for (int connectedId : currentActionNode->connectedToNodeIDs) {
-        BaseNode *potentialNextNode = player.GetPlayerNodeById(connectedId);
-        if (potentialNextNode &&
-            potentialNextNode->getNodeKind() == NodeKind::ACTION) {
-          nextNodeInSequenceId = potentialNextNode->id;
-          break;
-        }
-      }
+  }
+}
 
-      player.activeActionNodeId = (nextNodeInSequenceId == -1)
-                                      ? currentActionNode->id
-                                      : nextNodeInSequenceId;
+void NodesController::CancelAction(Player &player) {
+  if (activeAction != -1) {
+    actionScheduler.Cancel(activeAction);
+    TRACE_INSTANT("action cancel", player.activeActionNodeId);
+  }
+  activeAction = -1;
+  if (BaseNode *node = player.GetPlayerNodeById(player.activeActionNodeId))
+    node->isCurrentlyActiveEffect = false;
+  player.activeActionNodeId = -1;
+  player.playerShieldIsActive = false;
+  player.shiftSpeedBonus = 0.0f;
+}
 
-      BaseNode *newActionNode =
-          player.GetPlayerNodeById(player.activeActionNodeId);
-      if (newActionNode) {
-        StartNewAction(player, bullets, newActionNode);
-      } else {
-        player.activeActionNodeId = -1;
-        player.playerShieldIsActive = false;
-      }
+float NodesController::GetActionTimeLeft() const {
+  if (activeAction == -1)
+    return 0.0f;
+  return (float)fmax(0.0, activeActionEndsAt - actionScheduler.GetClock());
+}
+
+void NodesController::StartAction(Player &player, BulletStore &bullets,
+                                  BaseNode *actionNode, Vector2 aimPosition) {
+  TRACE_INSTANT("action start", actionNode->id);
+  player.activeActionNodeId = actionNode->id;
+  ActionTask task = {actionNode->id, 0, 0};
+  // The first phase runs on the tick the action starts
+  ActionWait wait = ResumeAction(player, bullets, aimPosition, task);
+  activeAction = wait.done ? -1 : actionScheduler.Schedule(task, wait.seconds);
+}
+
+ActionWait NodesController::ResumeAction(Player &player, BulletStore &bullets,
+                                         Vector2 aimPosition,
+                                         ActionTask &task) {
+  BaseNode *actionNode = player.GetPlayerNodeById(task.nodeId);
+  if (!actionNode) {
+    // Removed from the grid while it ran
+    activeAction = -1;
+    CancelAction(player);
+    return ActionWait::Done();
+  }
+
+  enum { BEGIN, BURST, END };
+  switch (task.phase) {
+  case BEGIN: {
+    float duration =
+        fmaxf(0.1f, CalculateEffectiveDuration(actionNode, player));
+    actionNode->isCurrentlyActiveEffect = true;
+    if (events)
+      events->TryPush({GameEventType::ACTION_STARTED, player.position, 0,
+                       actionNode->getNodeType(), actionNode->id});
+
+    if (actionNode->getNodeType() == NodeType::ACTION_FIRE)
+      FireActionBullet(player, bullets, *actionNode, aimPosition);
+    else if (actionNode->getNodeType() == NodeType::ACTION_SHIELD)
+      player.playerShieldIsActive = true;
+    else if (actionNode->getNodeType() == NodeType::ACTION_SHIFT)
+      player.shiftSpeedBonus = player.CalculateShiftBonus(*actionNode);
+
+    activeActionEndsAt = actionScheduler.GetClock() + duration;
+    if (actionNode->getNodeType() == NodeType::ACTION_BURST) {
+      // The first shot now, the rest one interval apart, and the hand-over
+      // one interval after the last
+      FireActionBullet(player, bullets, *actionNode, aimPosition);
+      task.phase = BURST;
+      task.counter = BURST_SHOTS - 1;
+      return ActionWait::For(duration / BURST_SHOTS);
     }
-  } else {
-    player.activeActionNodeId = -1;
-    player.playerShieldIsActive = false;
+    task.phase = END;
+    return ActionWait::For(duration);
   }
-}
 
-void NodesController::StartNewAction(Player &player, Bullet bullets[],
-                                     BaseNode *actionNode) {
-  float effectiveDuration = CalculateEffectiveDuration(actionNode, player);
-  actionNode->currentActiveTimer = fmaxf(0.1f, effectiveDuration);
-  actionNode->isCurrentlyActiveEffect = true;
+  case BURST: {
+    float duration =
+        fmaxf(0.1f, CalculateEffectiveDuration(actionNode, player));
+    FireActionBullet(player, bullets, *actionNode, aimPosition);
+    if (--task.counter == 0)
+      task.phase = END;
+    return ActionWait::For(duration / BURST_SHOTS);
+  }
 
-  if (actionNode->getNodeType() == NodeType::ACTION_FIRE)
-    FireActionBullet(player, bullets, *actionNode);
-  else if (actionNode->getNodeType() == NodeType::ACTION_SHIELD)
-    player.playerShieldIsActive = true;
+  case END: {
+    TRACE_INSTANT("action end", actionNode->id);
+    actionNode->isCurrentlyActiveEffect = false;
+    if (actionNode->getNodeType() == NodeType::ACTION_SHIELD)
+      player.playerShieldIsActive = false;
+    else if (actionNode->getNodeType() == NodeType::ACTION_SHIFT)
+      player.shiftSpeedBonus = 0.0f;
+
+    // Hand over to the ACTION successor, or run this one again
+    BaseNode *nextNode = actionNode;
+    for (int connectedId : actionNode->connectedToNodeIDs) {
+      BaseNode *potentialNextNode = player.GetPlayerNodeById(connectedId);
+      if (potentialNextNode &&
+          potentialNextNode->getNodeKind() == NodeKind::ACTION) {
+        nextNode = potentialNextNode;
+        break;
+      }
+    }
+    StartAction(player, bullets, nextNode, aimPosition);
+    return ActionWait::Done();
+  }
+  }
+  return ActionWait::Done();
 }
 
 float NodesController::CalculateEffectiveDuration(const BaseNode *actionNode,
-                                                  const Player &player) {
+                                                  const Player &player) const {
   float effectiveDuration = actionNode->duration;
   for (int fromId : actionNode->connectedFromNodeIDs) {
     BaseNode *modNode = player.GetPlayerNodeById(fromId);
@@ -201,7 +378,7 @@ float NodesController::CalculateEffectiveDuration(const BaseNode *actionNode,
 }
 
 float NodesController::CalculateEffectiveValue(const BaseNode *node,
-                                               const Player &player) {
+                                               const Player &player) const {
   float effectiveValue = node->value;
   for (int fromId : node->connectedFromNodeIDs) {
     BaseNode *powerNode = player.GetPlayerNodeById(fromId);
@@ -213,8 +390,8 @@ float NodesController::CalculateEffectiveValue(const BaseNode *node,
   return effectiveValue;
 }
 
-void NodesController::FireActionBullet(Player &player, Bullet bullets[],
-                                       const BaseNode &fireActionNode) {
+float NodesController::CalculateFireBonus(const BaseNode &fireActionNode,
+                                          const Player &player) const {
   float effectiveDamage = CalculateEffectiveValue(&fireActionNode, player);
 
   // Add damage stat bonuses
@@ -226,21 +403,24 @@ void NodesController::FireActionBullet(Player &player, Bullet bullets[],
       }
     }
   }
+  return effectiveDamage;
+}
 
-  for (int i = 0; i < MAX_BULLETS; i++) {
-    if (!bullets[i].active) {
-      bullets[i].active = true;
-      bullets[i].fromPlayer = true;
-      bullets[i].position = player.position;
-      Vector2 mousePos = GetMousePosition();
-      Vector2 direction =
-          Vector2Normalize(Vector2Subtract(mousePos, player.position));
-      if (Vector2LengthSqr(direction) == 0)
-        direction = {0, -1};
-      bullets[i].velocity = Vector2Scale(direction, BULLET_SPEED * 1.1f);
-      bullets[i].color = ORANGE;
-      bullets[i].damage = player.currentDamage + (int)effectiveDamage;
-      break;
-    }
-  }
+void NodesController::FireActionBullet(Player &player, BulletStore &bullets,
+                                       const BaseNode &fireActionNode,
+                                       Vector2 aimPosition) {
+  float effectiveDamage = CalculateFireBonus(fireActionNode, player);
+
+  int slot = bullets.FindFree(0);
+  if (slot == bullets.GetCapacity())
+    return;
+  Vector2 direction =
+      Vector2Normalize(Vector2Subtract(aimPosition, player.position));
+  if (Vector2LengthSqr(direction) == 0)
+    direction = {0, -1};
+  bullets.SetAlive(slot, true);
+  bullets.Get<Motion>(slot) = {player.position,
+                               Vector2Scale(direction, BULLET_SPEED * 1.1f)};
+  bullets.Get<Projectile>(slot) = {
+      ORANGE, player.currentDamage + (int)effectiveDamage, true};
 }
@@ -1,10 +1,12 @@
 #pragma once
+#include "ActionScheduler.h"
 #include "BaseNode.h"
+#include "Entities.h"
+#include "GameEvent.h"
 #include "Player.h"
 #include <map>
 #include <memory>
-
-struct Bullet;
+#include <vector>
 
 class NodesController {
 public:
@@ -13,24 +15,51 @@ public:
 
   void Initialize();
   void UpdateNodeActivation(Player &player);
-  void UpdateActionSystem(Player &player, Bullet bullets[], float dt);
+  // Links two placed nodes if the kinds allow it, replacing links the rules
+  // make exclusive. Returns true when the graph changed.
+  bool ConnectNodes(Player &player, int fromId, int toId);
+  // Resumes due actions and starts the sequence from the core when none
+  // is running. Each action is a task on actionScheduler.
+  void UpdateActionSystem(Player &player, BulletStore &bullets,
+                          Vector2 aimPosition, float dt);
+  // Stops the running action and undoes its effects. The sequence restarts
+  // from the core on the next tick.
+  void CancelAction(Player &player);
+  // Until the running action hands over, for the HUD
+  float GetActionTimeLeft() const;
 
   std::unique_ptr<BaseNode> CreateNodeFromTemplate(NodeType type);
+  BaseNode *GetTemplate(NodeType type) const;
   BaseNode *GetNodeById(int id, std::vector<std::unique_ptr<BaseNode>> &nodes);
 
-  void FireActionBullet(Player &player, Bullet bullets[],
-                        const BaseNode &fireActionNode);
+  void FireActionBullet(Player &player, BulletStore &bullets,
+                        const BaseNode &fireActionNode, Vector2 aimPosition);
+
+  // Action tuning after POWER and STAT modifiers, shared with BuildAnalyzer
+  float CalculateEffectiveDuration(const BaseNode *actionNode,
+                                   const Player &player) const;
+  float CalculateEffectiveValue(const BaseNode *node,
+                                const Player &player) const;
+  // Bonus a fire blast adds on top of the player's damage stat
+  float CalculateFireBonus(const BaseNode &fireActionNode,
+                           const Player &player) const;
 
   int GetNextNodeId() { return nextNodeId++; }
+  // Action starts are reported here as ACTION_STARTED; nullptr to skip
+  void SetEventQueue(GameEventQueue *queue) { events = queue; }
 
 private:
   std::map<NodeType, std::unique_ptr<BaseNode>> nodeTemplates;
   int nextNodeId;
+  GameEventQueue *events;
+
+  ActionScheduler actionScheduler;
+  ActionScheduler::Handle activeAction; // -1 when no action is parked
+  double activeActionEndsAt;
 
   void InitNodeTemplates();
-  void ProcessActionSequence(Player &player, Bullet bullets[], float dt);
-  void StartNewAction(Player &player, Bullet bullets[], BaseNode *actionNode);
-  float CalculateEffectiveDuration(const BaseNode *actionNode,
-                                   const Player &player);
-  float CalculateEffectiveValue(const BaseNode *node, const Player &player);
+  void StartAction(Player &player, BulletStore &bullets,
+                   BaseNode *actionNode, Vector2 aimPosition);
+  ActionWait ResumeAction(Player &player, BulletStore &bullets,
+                          Vector2 aimPosition, ActionTask &task);
 };
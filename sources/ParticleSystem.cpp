@@ -0,0 +1,183 @@
+#include "ParticleSystem.h"
+#include "CircleBatch.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+// Fill level where bursts start being thinned, and the smallest share of a
+// burst that still comes out once the budget is nearly full
+static const float THROTTLE_FILL = 0.75f;
+static const float THROTTLE_FLOOR = 0.25f;
+// Fraction of its speed a particle keeps per second
+static const float PARTICLE_DRAG = 0.05f;
+
+ParticleSystem::ParticleSystem(int budget)
+    : budget(0), count(0), pendingCount(0), dropped(0), random(0x9e3779b9) {
+  SetBudget(budget);
+}
+
+void ParticleSystem::SetBudget(int budget) {
+  this->budget = std::max(0, budget);
+  positionX.assign(this->budget, 0.0f);
+  positionY.assign(this->budget, 0.0f);
+  velocityX.assign(this->budget, 0.0f);
+  velocityY.assign(this->budget, 0.0f);
+  age.assign(this->budget, 0.0f);
+  lifetime.assign(this->budget, 0.0f);
+  size.assign(this->budget, 0.0f);
+  color.assign(this->budget, BLANK);
+  pending.reserve(256);
+  Clear();
+}
+
+void ParticleSystem::Clear() {
+  count = 0;
+  pending.clear();
+  pendingCount = 0;
+  dropped = 0;
+}
+
+void ParticleSystem::Emit(const ParticleBurst &burst) {
+  if (budget == 0 || burst.count <= 0)
+    return;
+  int wanted = burst.count;
+  float fill = (float)(count + pendingCount) / budget;
+  if (fill > THROTTLE_FILL) {
+    float share = std::max(THROTTLE_FLOOR,
+                           (1.0f - fill) / (1.0f - THROTTLE_FILL));
+    wanted = std::max(1, (int)ceilf(wanted * share));
+  }
+  // Nothing beyond one budget's worth can be shown this frame anyway
+  wanted = std::min(wanted, budget - pendingCount);
+  dropped += burst.count - std::max(0, wanted);
+  if (wanted <= 0)
+    return;
+  pending.push_back(burst);
+  pending.back().count = wanted;
+  pendingCount += wanted;
+}
+
+void ParticleSystem::Update(float dt) {
+  Integrate(dt);
+  Compact();
+  int evict = std::max(0, count + pendingCount - budget);
+  if (evict > 0)
+    Evict(evict);
+  for (const ParticleBurst &burst : pending)
+    Spawn(burst);
+  pending.clear();
+  pendingCount = 0;
+}
+
+void ParticleSystem::Integrate(float dt) {
+  float damping = powf(PARTICLE_DRAG, dt);
+  float *x = positionX.data();
+  float *y = positionY.data();
+  float *vx = velocityX.data();
+  float *vy = velocityY.data();
+  float *ages = age.data();
+  int i = 0;
+#ifdef PARTICLES_SSE2
+  __m128 step = _mm_set1_ps(dt);
+  __m128 keep = _mm_set1_ps(damping);
+  for (; i + 4 <= count; i += 4) {
+    __m128 velX = _mm_loadu_ps(vx + i);
+    __m128 velY = _mm_loadu_ps(vy + i);
+    _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i),
+                                    _mm_mul_ps(velX, step)));
+    _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+                                    _mm_mul_ps(velY, step)));
+    _mm_storeu_ps(vx + i, _mm_mul_ps(velX, keep));
+    _mm_storeu_ps(vy + i, _mm_mul_ps(velY, keep));
+    _mm_storeu_ps(ages + i, _mm_add_ps(_mm_loadu_ps(ages + i), step));
+  }
+#endif
+  for (; i < count; i++) {
+    x[i] += vx[i] * dt;
+    y[i] += vy[i] * dt;
+    vx[i] *= damping;
+    vy[i] *= damping;
+    ages[i] += dt;
+  }
+}
+
+void ParticleSystem::Compact() {
+  int kept = 0;
+  for (int i = 0; i < count; i++) {
+    if (age[i] >= lifetime[i])
+      continue;
+    if (kept != i) {
+      positionX[kept] = positionX[i];
+      positionY[kept] = positionY[i];
+      velocityX[kept] = velocityX[i];
+      velocityY[kept] = velocityY[i];
+      age[kept] = age[i];
+      lifetime[kept] = lifetime[i];
+      size[kept] = size[i];
+      color[kept] = color[i];
+    }
+    kept++;
+  }
+  count = kept;
+}
+
+void ParticleSystem::Evict(int oldest) {
+  oldest = std::min(oldest, count);
+  auto shift = [&](auto &column) {
+    std::copy(column.begin() + oldest, column.begin() + count, column.begin());
+  };
+  shift(positionX);
+  shift(positionY);
+  shift(velocityX);
+  shift(velocityY);
+  shift(age);
+  shift(lifetime);
+  shift(size);
+  shift(color);
+  count -= oldest;
+  dropped += oldest;
+}
+
+void ParticleSystem::Spawn(const ParticleBurst &burst) {
+  int spawn = std::min(burst.count, budget - count);
+  float spacing = 2.0f * PI / std::max(1, spawn);
+  float offset = RandomUnit() * spacing;
+  for (int k = 0; k < spawn; k++) {
+    int i = count++;
+    float angle = offset + k * spacing;
+    float speed = burst.speed;
+    if (!burst.ring) {
+      angle = RandomUnit() * 2.0f * PI;
+      speed *= 0.3f + 0.7f * RandomUnit();
+    }
+    positionX[i] = burst.position.x;
+    positionY[i] = burst.position.y;
+    velocityX[i] = cosf(angle) * speed;
+    velocityY[i] = sinf(angle) * speed;
+    age[i] = 0.0f;
+    lifetime[i] = burst.lifetime * (0.6f + 0.4f * RandomUnit());
+    size[i] = burst.size;
+    color[i] = burst.color;
+  }
+}
+
+float ParticleSystem::RandomUnit() {
+  return (random.Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::Draw(CircleBatch &batch) const {
+  batch.Begin();
+  for (int i = 0; i < count; i++) {
+    // Fade out and shrink to half size over the lifetime
+    float left = 1.0f - age[i] / lifetime[i];
+    Color tint = color[i];
+    tint.a = (unsigned char)(tint.a * left);
+    batch.Add({positionX[i], positionY[i]}, size[i] * (0.5f + 0.5f * left),
+              tint);
+  }
+  batch.End();
+}
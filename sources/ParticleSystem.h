@@ -0,0 +1,79 @@
+#pragma once
+#include "GameRandom.h"
+#include "raylib.h"
+#include <vector>
+
+class CircleBatch;
+
+const int MAX_PARTICLES = 50000;
+
+// A spray of particles from one point, launched in random directions (or
+// evenly around a ring) and fading out over their lifetime
+struct ParticleBurst {
+  Vector2 position;
+  Color color;
+  int count;
+  float speed;    // Fastest launch speed in pixels per second
+  float lifetime; // Seconds for the longest-lived particle
+  float size;     // Starting radius
+  bool ring;      // Every particle at full speed, evenly spaced
+};
+
+// Purely visual particles for hits, deaths and actions, updated and drawn
+// on the main thread. Each field is its own array so the integration runs
+// four particles per SSE instruction. Particles stay sorted oldest first,
+// so the budget is enforced by dropping a prefix.
+//
+// Past three quarters of the budget, bursts are thinned the fuller it
+// gets; once it's full, the oldest particles make room for the new ones.
+class ParticleSystem {
+public:
+  explicit ParticleSystem(int budget = MAX_PARTICLES);
+
+  // Disable copy and move operations
+  ParticleSystem(const ParticleSystem &) = delete;
+  ParticleSystem &operator=(const ParticleSystem &) = delete;
+  ParticleSystem(ParticleSystem &&) = delete;
+  ParticleSystem &operator=(ParticleSystem &&) = delete;
+
+  // Drops every particle
+  void SetBudget(int budget);
+  void Clear();
+
+  // Queued until the next Update, so bursts from a frame are placed in one
+  // pass
+  void Emit(const ParticleBurst &burst);
+  void Update(float dt);
+  // All live particles in one circle batch
+  void Draw(CircleBatch &batch) const;
+
+  int GetLiveCount() const { return count; }
+  int GetBudget() const { return budget; }
+  // Particles thinned out or evicted since the last Clear
+  long long GetDroppedCount() const { return dropped; }
+
+private:
+  int budget;
+  int count;
+  std::vector<float> positionX;
+  std::vector<float> positionY;
+  std::vector<float> velocityX;
+  std::vector<float> velocityY;
+  std::vector<float> age;
+  std::vector<float> lifetime;
+  std::vector<float> size;
+  std::vector<Color> color;
+
+  std::vector<ParticleBurst> pending;
+  int pendingCount;
+  long long dropped;
+  GameRandom random;
+
+  void Integrate(float dt);
+  // Removes expired particles, keeping the rest in order
+  void Compact();
+  // Makes room by dropping the oldest particles
+  void Evict(int oldest);
+  void Spawn(const ParticleBurst &burst);
+  float RandomUnit(); // [0, 1)
+};
@@ -12,7 +12,10 @@ Player::Player() {
   baseDamage = 10;
   activeActionNodeId = -1;
   playerShieldIsActive = false;
+  shiftSpeedBonus = 0.0f;
   fireCooldownTimer = 0.0f;
+  // At most one stack per type, so drops never grow it mid-run
+  inventoryStacks.reserve(NODE_TYPE_COUNT);
   resetStats();
 }
 
@@ -34,8 +37,8 @@ void Player::resetStats() {
   currentDamage = baseDamage;
 }
 
-void Player::applyNodeEffects() {
-  resetStats();
+PlayerStats Player::CalculateNodeStats() const {
+  PlayerStats stats = {baseHealth, baseSpeed, baseDamage, baseFireRate};
   for (auto &node : placedNodes) {
     if (node->isActive && node->getNodeKind() == NodeKind::STAT) {
       float effectiveStatValue = node->value;
@@ -49,62 +52,76 @@ void Player::applyNodeEffects() {
       }
       switch (node->getNodeType()) {
       case NodeType::STAT_HEALTH:
-        maxHealth += (int)effectiveStatValue;
+        stats.maxHealth += (int)effectiveStatValue;
         break;
       case NodeType::STAT_SPEED:
-        currentSpeed += effectiveStatValue;
+        stats.speed += effectiveStatValue;
         break;
       case NodeType::STAT_DAMAGE:
-        currentDamage += (int)effectiveStatValue;
+        stats.damage += (int)effectiveStatValue;
         break;
       case NodeType::STAT_FIRE_RATE:
-        currentFireRate -= effectiveStatValue;
-        if (currentFireRate < 0.05f)
-          currentFireRate = 0.05f;
+        stats.fireRate -= effectiveStatValue;
+        if (stats.fireRate < 0.05f)
+          stats.fireRate = 0.05f;
         break;
       default:
         break;
       }
     }
   }
+  return stats;
+}
 
-  // Handle shift action effects
-  if (activeActionNodeId != -1) {
-    BaseNode *currentAction = GetPlayerNodeById(activeActionNodeId);
-    if (currentAction &&
-        currentAction->getNodeType() == NodeType::ACTION_SHIFT &&
-        currentAction->isCurrentlyActiveEffect) {
-      float shiftEffectiveValue = currentAction->value;
-      for (int fromId : currentAction->connectedFromNodeIDs) {
-        BaseNode *modNode = GetPlayerNodeById(fromId);
-        if (modNode && modNode->isActive) {
-          if (modNode->getNodeType() == NodeType::POWER_VALUE_ADD) {
-            shiftEffectiveValue += modNode->value;
-          } else if (modNode->getNodeType() == NodeType::STAT_SPEED) {
-            shiftEffectiveValue += modNode->value;
-          }
-        }
+float Player::CalculateShiftBonus(const BaseNode &shiftNode) const {
+  float shiftEffectiveValue = shiftNode.value;
+  for (int fromId : shiftNode.connectedFromNodeIDs) {
+    BaseNode *modNode = GetPlayerNodeById(fromId);
+    if (modNode && modNode->isActive) {
+      if (modNode->getNodeType() == NodeType::POWER_VALUE_ADD) {
+        shiftEffectiveValue += modNode->value;
+      } else if (modNode->getNodeType() == NodeType::STAT_SPEED) {
+        shiftEffectiveValue += modNode->value;
       }
-      currentSpeed += shiftEffectiveValue;
     }
   }
+  return shiftEffectiveValue;
+}
+
+void Player::applyNodeEffects() {
+  resetStats();
+  PlayerStats stats = CalculateNodeStats();
+  maxHealth = stats.maxHealth;
+  currentSpeed = stats.speed;
+  currentDamage = stats.damage;
+  currentFireRate = stats.fireRate;
+  currentSpeed += shiftSpeedBonus;
 
   if (currentHealth > maxHealth)
     currentHealth = maxHealth;
 }
 
-std::vector<BaseNode *> Player::GetInventoryNodePtrs() const {
-  std::vector<BaseNode *> ptrs;
-  for (const auto &node : inventoryNodes) {
-    ptrs.push_back(node.get());
+void Player::AddInventoryNode(NodeType type, int count) {
+  for (auto &stack : inventoryStacks) {
+    if (stack.type == type) {
+      stack.count += count;
+      return;
+    }
   }
-  return ptrs;
+  inventoryStacks.push_back({type, count});
 }
 
-std::vector<BaseNode *> Player::GetPlacedNodePtrs() const {
-  std::vector<BaseNode *> ptrs;
-  for (const auto &node : placedNodes) {
-    ptrs.push_back(node.get());
-  }
-  return ptrs;
+bool Player::TakeInventoryNode(size_t stackIndex) {
+  if (stackIndex >= inventoryStacks.size())
+    return false;
+  if (--inventoryStacks[stackIndex].count <= 0)
+    inventoryStacks.erase(inventoryStacks.begin() + stackIndex);
+  return true;
+}
+
+int Player::GetInventoryNodeCount() const {
+  int total = 0;
+  for (const auto &stack : inventoryStacks)
+    total += stack.count;
+  return total;
 }
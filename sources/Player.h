@@ -4,6 +4,23 @@
 #include <vector>
 #include <memory>
 
+// Unplaced nodes of the same type are interchangeable, so the inventory only
+// stores how many of each type the player owns. A BaseNode instance is created
+// when one is dragged onto the grid.
+struct InventoryStack {
+  NodeType type;
+  int count;
+};
+
+// Stats from the base values and the active STAT nodes, before the
+// temporary shift bonus
+struct PlayerStats {
+  int maxHealth;
+  float speed;
+  int damage;
+  float fireRate;
+};
+
 class Player {
 public:
   Vector2 position;
@@ -13,19 +30,24 @@ public:
   float fireCooldownTimer;
   int baseDamage, currentDamage;
 
-  std::vector<std::unique_ptr<BaseNode>> inventoryNodes;
+  std::vector<InventoryStack> inventoryStacks;
   std::vector<std::unique_ptr<BaseNode>> placedNodes;
 
   int activeActionNodeId;
-  bool playerShieldIsActive;
+  bool playerShieldIsActive; // Raised and dropped by the shield action
+  float shiftSpeedBonus;     // Set for the duration of a shift action
 
   Player();
 
   BaseNode* GetPlayerNodeById(int id) const;
   void resetStats();
   void applyNodeEffects();
+  // Read only the graph, never the live stats the tick rewrites
+  PlayerStats CalculateNodeStats() const;
+  float CalculateShiftBonus(const BaseNode &shiftNode) const;
 
-  // Helper methods for getting raw pointers for the UI classes
-  std::vector<BaseNode*> GetInventoryNodePtrs() const;
-  std::vector<BaseNode*> GetPlacedNodePtrs() const;
+  // Inventory stacks
+  void AddInventoryNode(NodeType type, int count = 1);
+  bool TakeInventoryNode(size_t stackIndex);
+  int GetInventoryNodeCount() const;
 };
\ No newline at end of file
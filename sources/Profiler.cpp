@@ -0,0 +1,128 @@
+#include "Profiler.h"
+#include "raylib.h"
+#include <algorithm>
+
+static const float PROFILER_WINDOW = 0.5f;
+static_assert((int)ProfileZone::COUNT <= AllocTracker::MAX_ZONES,
+              "every zone needs an allocation counter");
+
+const char *GetProfileZoneName(ProfileZone zone) {
+  switch (zone) {
+  case ProfileZone::TICK:
+    return "tick";
+  case ProfileZone::ACTIONS:
+    return "  actions";
+  case ProfileZone::BULLET_MOTION:
+    return "  bullet motion";
+  case ProfileZone::HOSTILE_HITS:
+    return "  hostile hits";
+  case ProfileZone::ENEMIES:
+    return "  enemies";
+  case ProfileZone::ENEMY_FIRE:
+    return "  enemy fire";
+  case ProfileZone::EVENTS:
+    return "  events";
+  case ProfileZone::SPAWNING:
+    return "  spawning";
+  case ProfileZone::DRAW:
+    return "draw";
+  case ProfileZone::PARTICLES:
+    return "particles";
+  case ProfileZone::UI:
+    return "ui";
+  case ProfileZone::COUNT:
+    break;
+  }
+  return "?";
+}
+
+const char *GetProfileZoneTraceName(ProfileZone zone) {
+  const char *name = GetProfileZoneName(zone);
+  while (*name == ' ')
+    name++;
+  return name;
+}
+
+Profiler::Profiler()
+    : summaries(), allocSummary(), windowAllocs(), windowMaxAllocations(0),
+      windowFrames(0), windowTime(0.0f), visible(false) {
+  for (LiveZone &zone : live) {
+    zone.nanoseconds.store(0, std::memory_order_relaxed);
+    zone.maxNanoseconds.store(0, std::memory_order_relaxed);
+  }
+}
+
+void Profiler::Record(ProfileZone zone, uint64_t nanoseconds) {
+  LiveZone &entry = live[(int)zone];
+  entry.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  uint64_t longest = entry.maxNanoseconds.load(std::memory_order_relaxed);
+  while (nanoseconds > longest &&
+         !entry.maxNanoseconds.compare_exchange_weak(
+             longest, nanoseconds, std::memory_order_relaxed))
+    ;
+}
+
+void Profiler::EndFrame(float dt) {
+  windowFrames++;
+  windowTime += dt;
+  if (AllocTracker::IsEnabled()) {
+    AllocCounts frame = AllocTracker::TakeTotals();
+    windowAllocs.allocations += frame.allocations;
+    windowAllocs.bytes += frame.bytes;
+    windowMaxAllocations = std::max(windowMaxAllocations, frame.allocations);
+  }
+  if (windowTime < PROFILER_WINDOW)
+    return;
+
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    uint64_t nanoseconds =
+        live[i].nanoseconds.exchange(0, std::memory_order_relaxed);
+    uint64_t longest =
+        live[i].maxNanoseconds.exchange(0, std::memory_order_relaxed);
+    summaries[i].msPerFrame = nanoseconds / 1e6 / windowFrames;
+    summaries[i].maxMs = longest / 1e6;
+    summaries[i].allocationsPerFrame =
+        (double)AllocTracker::TakeZone(i).allocations / windowFrames;
+  }
+  allocSummary.allocationsPerFrame =
+      (double)windowAllocs.allocations / windowFrames;
+  allocSummary.bytesPerFrame = (double)windowAllocs.bytes / windowFrames;
+  allocSummary.maxAllocations = windowMaxAllocations;
+  windowAllocs = {};
+  windowMaxAllocations = 0;
+  windowFrames = 0;
+  windowTime = 0.0f;
+}
+
+void Profiler::Draw(int x, int y) const {
+  const int lineHeight = 16;
+  bool allocs = AllocTracker::IsEnabled();
+  int lines = ZONE_COUNT + (allocs ? 2 : 1);
+  DrawRectangle(x - 5, y - 5, allocs ? 370 : 300, lineHeight * lines + 10,
+                ColorAlpha(BLACK, 0.7f));
+  DrawText(allocs ? "zone            ms/frame    max ms    allocs (F4)"
+                  : "zone            ms/frame    max ms (F4)",
+           x, y, 10, GRAY);
+  for (int i = 0; i < ZONE_COUNT; i++) {
+    const ZoneSummary &summary = summaries[i];
+    int lineY = y + lineHeight * (i + 1);
+    DrawText(GetProfileZoneName((ProfileZone)i), x, lineY, 10, LIGHTGRAY);
+    DrawText(TextFormat("%8.3f", summary.msPerFrame), x + 110, lineY, 10,
+             LIGHTGRAY);
+    DrawText(TextFormat("%8.3f", summary.maxMs), x + 190, lineY, 10,
+             LIGHTGRAY);
+    if (allocs)
+      DrawText(TextFormat("%8.1f", summary.allocationsPerFrame), x + 260,
+               lineY, 10,
+               summary.allocationsPerFrame > 0.0 ? ORANGE : LIGHTGRAY);
+  }
+  if (allocs) {
+    // Anything above zero in a steady frame is worth a look
+    const AllocSummary &heap = allocSummary;
+    DrawText(TextFormat("heap: %.1f allocs, %.1f KB per frame, max %llu",
+                        heap.allocationsPerFrame, heap.bytesPerFrame / 1024.0,
+                        (unsigned long long)heap.maxAllocations),
+             x, y + lineHeight * (ZONE_COUNT + 1), 10,
+             heap.maxAllocations > 0 ? ORANGE : LIGHTGRAY);
+  }
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "AllocTracker.h"
+#include "Tracer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Fixed set of timed sections, so recording is an array index
+enum class ProfileZone {
+  TICK,
+  ACTIONS,
+  BULLET_MOTION,
+  HOSTILE_HITS,
+  ENEMIES,
+  ENEMY_FIRE,
+  EVENTS,
+  SPAWNING,
+  DRAW,
+  PARTICLES,
+  UI,
+  COUNT
+};
+
+const char *GetProfileZoneName(ProfileZone zone);
+// Without the overlay's nesting indent
+const char *GetProfileZoneTraceName(ProfileZone zone);
+
+// Per-zone wall time, recorded from any thread without locks and shown as
+// averages over half-second windows. Nested zones count toward their
+// parent too, so the tick line includes every tick phase below it.
+//
+// With allocation tracking compiled in (see AllocTracker.h) it also shows
+// heap allocations per zone and per frame.
+class Profiler {
+public:
+  struct ZoneSummary {
+    double msPerFrame; // Average time in the zone per rendered frame
+    double maxMs;      // Longest single pass in the window
+    double allocationsPerFrame;
+  };
+
+  struct AllocSummary {
+    double allocationsPerFrame; // Every thread, inside a zone or not
+    double bytesPerFrame;
+    uint64_t maxAllocations; // Most in a single frame of the window
+  };
+
+  Profiler();
+
+  // Disable copy and move operations
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+  Profiler(Profiler &&) = delete;
+  Profiler &operator=(Profiler &&) = delete;
+
+  // Any thread
+  void Record(ProfileZone zone, uint64_t nanoseconds);
+
+  // Main thread, once per frame: closes the window every half second
+  void EndFrame(float dt);
+  const ZoneSummary &GetSummary(ProfileZone zone) const {
+    return summaries[(int)zone];
+  }
+  const AllocSummary &GetAllocSummary() const { return allocSummary; }
+
+  bool IsVisible() const { return visible; }
+  void SetVisible(bool visible) { this->visible = visible; }
+  void Draw(int x, int y) const;
+
+private:
+  static const int ZONE_COUNT = (int)ProfileZone::COUNT;
+
+  struct alignas(64) LiveZone {
+    std::atomic<uint64_t> nanoseconds;
+    std::atomic<uint64_t> maxNanoseconds;
+  };
+
+  LiveZone live[ZONE_COUNT];
+  ZoneSummary summaries[ZONE_COUNT];
+  AllocSummary allocSummary;
+  AllocCounts windowAllocs;
+  uint64_t windowMaxAllocations;
+  int windowFrames;
+  float windowTime;
+  bool visible;
+};
+
+// Times its own lifetime into a zone, and marks it on the trace timeline
+// and attributes allocations to it when those are compiled in. A null
+// profiler costs one branch. Like TraceScope, it decides once whether to
+// trace, so starting or stopping a recording mid-scope can't leave a begin
+// or end event unmatched.
+class ProfileScope {
+public:
+  ProfileScope(Profiler *profiler, ProfileZone zone)
+      : profiler(profiler), zone(zone) {
+#ifdef RRL_ALLOC_TRACKING
+    outerZones = AllocTracker::EnterZone((int)zone);
+#endif
+#ifdef RRL_TRACING
+    tracing = Tracer::IsRecording();
+    if (tracing)
+      Tracer::Begin(GetProfileZoneTraceName(zone));
+#endif
+    if (profiler)
+      start = std::chrono::steady_clock::now();
+  }
+  ~ProfileScope() {
+    if (profiler)
+      profiler->Record(zone, std::chrono::duration_cast<
+                                 std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count());
+#ifdef RRL_TRACING
+    if (tracing)
+      Tracer::End(GetProfileZoneTraceName(zone));
+#endif
+#ifdef RRL_ALLOC_TRACKING
+    AllocTracker::LeaveZone(outerZones);
+#endif
+  }
+
+  // Disable copy and move operations
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+  ProfileScope(ProfileScope &&) = delete;
+  ProfileScope &operator=(ProfileScope &&) = delete;
+
+private:
+  Profiler *profiler;
+  ProfileZone zone;
+  std::chrono::steady_clock::time_point start;
+#ifdef RRL_TRACING
+  bool tracing;
+#endif
+#ifdef RRL_ALLOC_TRACKING
+  uint32_t outerZones;
+#endif
+};
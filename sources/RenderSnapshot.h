@@ -0,0 +1,47 @@
+#pragma once
+#include "BaseNode.h"
+#include "GameWorld.h"
+#include "raylib.h"
+#include <vector>
+
+const int MAX_INVENTORY_STACKS = NODE_TYPE_COUNT;
+
+struct SnapshotBullet {
+  Vector2 position;
+  Color color;
+};
+
+struct SnapshotEnemy {
+  Vector2 position;
+  int health;
+};
+
+// Immutable copy of everything the main thread draws from the world. Slots
+// are written in place and keep their capacity, so once the entity counts
+// have peaked publishing one no longer allocates.
+//
+// The node graph's structure (placed nodes, links, panel positions) is only
+// ever changed by the main thread, so it is drawn from Player directly; only
+// the parts the tick mutates are copied here.
+struct RenderSnapshot {
+  unsigned long long tick;
+  GameState state;
+
+  Vector2 playerPosition;
+  bool playerShieldIsActive;
+  int currentHealth;
+  int maxHealth;
+  float currentSpeed;
+  int currentDamage;
+  float currentFireRate;
+
+  int activeActionNodeId;
+  bool activeActionIsEffect;
+  float activeActionTimer;
+
+  std::vector<SnapshotBullet> bullets;
+  std::vector<SnapshotEnemy> enemies;
+
+  int inventoryCount;
+  InventoryStack inventory[MAX_INVENTORY_STACKS];
+};
@@ -0,0 +1,207 @@
+#include "ReplayLog.h"
+#include "BuildSpec.h"
+#include "raylib.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+// 64-bit FNV-1a, fed field by field so padding never reaches it
+class StateHash {
+public:
+  void Bytes(const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  void Int(long long value) { Bytes(&value, sizeof(value)); }
+  void Float(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Bytes(&bits, sizeof(bits));
+  }
+  void Vector(Vector2 value) {
+    Float(value.x);
+    Float(value.y);
+  }
+  uint64_t Get() const { return hash; }
+
+private:
+  uint64_t hash = 14695981039346656037ull;
+};
+
+} // namespace
+
+bool LoadReplayLog(const std::string &path, ReplayLog &log) {
+  char *text = LoadFileText(path.c_str());
+  if (!text) {
+    TraceLog(LOG_WARNING, "REPLAY: could not read %s", path.c_str());
+    return false;
+  }
+
+  ReplayLog loaded;
+  bool valid = true;
+  std::istringstream lines(text);
+  UnloadFileText(text);
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line)) {
+    lineNumber++;
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword[0] == '#')
+      continue;
+
+    bool entryValid = true;
+    if (keyword == "i") {
+      PlayerInput input = {};
+      int fire = 0;
+      entryValid = (bool)(tokens >> input.moveDir.x >> input.moveDir.y >>
+                          input.aimPosition.x >> input.aimPosition.y >> fire);
+      input.fireHeld = fire != 0;
+      if (entryValid)
+        loaded.inputs.push_back(input);
+    } else if (keyword == "seed") {
+      entryValid = (bool)(tokens >> loaded.seed);
+    } else if (keyword == "rate") {
+      entryValid = (tokens >> loaded.tickRate) && loaded.tickRate > 0;
+    } else if (keyword == "arena") {
+      entryValid = (tokens >> loaded.width >> loaded.height) &&
+                   loaded.width > 0 && loaded.height > 0;
+    } else if (keyword == "enemies") {
+      entryValid = (tokens >> loaded.enemies) && loaded.enemies > 0;
+    } else if (keyword == "endless") {
+      int endless = 0;
+      entryValid = (bool)(tokens >> endless);
+      loaded.endless = endless != 0;
+    } else if (keyword == "build") {
+      entryValid = (bool)(tokens >> loaded.buildPath);
+    } else if (keyword == "hash") {
+      entryValid = (bool)(tokens >> std::hex >> loaded.finalHash);
+    } else if (keyword == "budget") {
+      entryValid = (tokens >> loaded.budgetUs) && loaded.budgetUs >= 0.0;
+    } else {
+      TraceLog(LOG_WARNING, "REPLAY: %s:%d: unknown entry '%s'", path.c_str(),
+               lineNumber, keyword.c_str());
+      valid = false;
+      continue;
+    }
+
+    if (!entryValid) {
+      TraceLog(LOG_WARNING, "REPLAY: %s:%d: malformed %s entry",
+               path.c_str(), lineNumber, keyword.c_str());
+      valid = false;
+    }
+  }
+
+  if (!valid)
+    return false;
+  log = std::move(loaded);
+  return true;
+}
+
+bool SaveReplayLog(const std::string &path, const ReplayLog &log) {
+  FILE *file = fopen(path.c_str(), "w");
+  if (!file)
+    return false;
+
+  fprintf(file, "seed %llu\n", (unsigned long long)log.seed);
+  fprintf(file, "rate %d\n", log.tickRate);
+  fprintf(file, "arena %d %d\n", log.width, log.height);
+  fprintf(file, "enemies %d\n", log.enemies);
+  fprintf(file, "endless %d\n", log.endless ? 1 : 0);
+  if (!log.buildPath.empty())
+    fprintf(file, "build %s\n", log.buildPath.c_str());
+  fprintf(file, "hash %016llx\n", (unsigned long long)log.finalHash);
+  if (log.budgetUs > 0.0)
+    fprintf(file, "budget %g\n", log.budgetUs);
+  for (const PlayerInput &input : log.inputs)
+    fprintf(file, "i %g %g %.9g %.9g %d\n", input.moveDir.x, input.moveDir.y,
+            input.aimPosition.x, input.aimPosition.y, input.fireHeld ? 1 : 0);
+
+  bool written = !ferror(file);
+  fclose(file);
+  return written;
+}
+
+PlayerInput QuantizeInput(const PlayerInput &input) {
+  // Adding 0 turns -0 into 0, keeping the logs free of "-0"
+  PlayerInput quantized = input;
+  quantized.moveDir = {roundf(input.moveDir.x) + 0.0f,
+                       roundf(input.moveDir.y) + 0.0f};
+  quantized.aimPosition = {roundf(input.aimPosition.x) + 0.0f,
+                           roundf(input.aimPosition.y) + 0.0f};
+  return quantized;
+}
+
+bool PrepareReplayWorld(const ReplayLog &log, const std::string &logDir,
+                        GameWorld &world) {
+  world.Seed(log.seed);
+  world.Init();
+  if (log.endless)
+    world.SetEndlessWave();
+  if (!log.buildPath.empty()) {
+    std::string buildPath =
+        logDir.empty() ? log.buildPath : logDir + "/" + log.buildPath;
+    BuildSpec spec;
+    if (!LoadBuildSpec(buildPath, spec) || !ApplyBuildSpec(spec, world))
+      return false;
+  }
+  world.state = GameState::GAMEPLAY;
+  return true;
+}
+
+uint64_t HashWorldState(const GameWorld &world) {
+  StateHash hash;
+  hash.Int((int)world.state);
+  hash.Int((long long)world.GetTickCount());
+
+  const RunStats &stats = world.GetStats();
+  hash.Float(stats.elapsed);
+  hash.Int(stats.kills);
+  hash.Int(stats.damageDealt);
+  hash.Int(stats.damageTaken);
+  hash.Int(stats.wave);
+  // Only types that ran, by index, so appending a node type to the enum
+  // leaves recorded hashes valid
+  for (int type = 0; type < NODE_TYPE_COUNT; type++) {
+    if (stats.activations[type] == 0)
+      continue;
+    hash.Int(type);
+    hash.Int(stats.activations[type]);
+  }
+
+  const Player &player = world.player;
+  hash.Vector(player.position);
+  hash.Float(player.currentSpeed);
+  hash.Int(player.currentHealth);
+  hash.Int(player.maxHealth);
+  hash.Float(player.fireCooldownTimer);
+  hash.Int(player.currentDamage);
+  hash.Int(player.activeActionNodeId);
+  hash.Int(player.playerShieldIsActive);
+  hash.Float(player.shiftSpeedBonus);
+
+  world.bullets.ForEachAlive(
+      [&](int slot, const Motion &motion, const Projectile &projectile) {
+        hash.Int(slot);
+        hash.Vector(motion.position);
+        hash.Vector(motion.velocity);
+        hash.Int(projectile.damage);
+        hash.Int(projectile.fromPlayer);
+      });
+  world.enemies.ForEachAlive(
+      [&](int slot, const EnemyBody &body, const EnemyGun &gun) {
+        hash.Int(slot);
+        hash.Vector(body.position);
+        hash.Float(body.speed);
+        hash.Int(body.health);
+        hash.Float(gun.currentShootTimer);
+        hash.Int(gun.pattern);
+        hash.Float(gun.patternPhase);
+      });
+  return hash.Get();
+}
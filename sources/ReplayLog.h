@@ -0,0 +1,52 @@
+#pragma once
+#include "GameWorld.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A headless session as the input of every fixed tick, so it can be
+// replayed bit for bit and its final state checked. Plain text:
+//
+//   seed 7                    # world seed
+//   rate 60                   # ticks per second
+//   arena 1600 1200
+//   enemies 1000              # enemy pool size
+//   endless 1                 # keep the pool full (GameWorld::SetEndlessWave)
+//   build ../builds/x.txt     # BuildSpec, relative to the log; optional
+//   hash 9f3c04e2a1b07d55     # state hash after the last tick
+//   budget 200                # p99 tick budget in microseconds; optional
+//   i 1 0 812 433 1           # one tick: move x y, aim x y, fire
+//
+// Inputs are stored as the keyboard and mouse would give them (WASD axes,
+// whole-pixel aim), so a recording is exactly what a replay feeds in.
+// Sessions use the built-in waves and bullet patterns, like batch runs.
+struct ReplayLog {
+  uint64_t seed = 1;
+  int tickRate = 60;
+  int width = 1600;
+  int height = 1200;
+  int enemies = MAX_ENEMIES;
+  bool endless = false;
+  std::string buildPath; // As written; empty for the starting build
+  uint64_t finalHash = 0; // 0 when not recorded
+  double budgetUs = 0.0;  // p99 tick time, 0 for none
+  std::vector<PlayerInput> inputs;
+};
+
+// Returns false when the file can't be read or has malformed entries
+bool LoadReplayLog(const std::string &path, ReplayLog &log);
+bool SaveReplayLog(const std::string &path, const ReplayLog &log);
+
+// The input as a log stores it
+PlayerInput QuantizeInput(const PlayerInput &input);
+
+// Seeds and initialises a world built with the log's arena and enemy
+// pool, applies its build (resolved against logDir) and starts the run.
+// Returns false if the build can't be loaded or applied.
+bool PrepareReplayWorld(const ReplayLog &log, const std::string &logDir,
+                        GameWorld &world);
+
+// FNV-1a over everything a tick advances: the tick count, run stats, the
+// player and every live bullet and enemy, floats by their bits. Node types
+// that never ran don't enter it, so new ones can be appended to NodeType.
+uint64_t HashWorldState(const GameWorld &world);
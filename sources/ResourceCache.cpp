@@ -0,0 +1,126 @@
+#include "ResourceCache.h"
+
+ResourceCache::ResourceCache()
+    : placeholder(), tasksInFlight(0), stopping(false) {}
+
+ResourceCache::~ResourceCache() { Unload(); }
+
+void ResourceCache::Init() {
+  if (loader.joinable())
+    return;
+
+  Image checked = GenImageChecked(16, 16, 4, 4, MAGENTA, BLACK);
+  placeholder = LoadTextureFromImage(checked);
+  UnloadImage(checked);
+
+  stopping = false;
+  loader = std::thread(&ResourceCache::LoaderLoop, this);
+}
+
+void ResourceCache::Unload() {
+  if (loader.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    loader.join();
+  }
+
+  // Pending work is dropped; its finish callbacks never run
+  queued.clear();
+  finished.clear();
+  tasksInFlight = 0;
+
+  for (auto &entry : textures) {
+    TextureResource &resource = *entry.second;
+    if (resource.ready)
+      UnloadTexture(resource.texture);
+    resource.ready = false;
+  }
+  textures.clear();
+
+  if (placeholder.id != 0)
+    UnloadTexture(placeholder);
+  placeholder = {0};
+}
+
+TextureHandle ResourceCache::GetTexture(const std::string &path) {
+  auto it = textures.find(path);
+  if (it != textures.end())
+    return TextureHandle(it->second);
+
+  auto resource = std::make_shared<TextureResource>();
+  resource->texture = {0};
+  resource->ready = false;
+  resource->placeholder = &placeholder;
+  textures[path] = resource;
+
+  // The image is shared by the two halves of the task
+  auto image = std::make_shared<Image>();
+  Enqueue([path, image]() { *image = LoadImage(path.c_str()); },
+          [path, image, resource]() {
+            if (!image->data) {
+              TraceLog(LOG_WARNING, "ResourceCache: could not decode %s",
+                       path.c_str());
+              return;
+            }
+            resource->texture = LoadTextureFromImage(*image);
+            resource->ready = resource->texture.id != 0;
+            UnloadImage(*image);
+          });
+  return TextureHandle(resource);
+}
+
+void ResourceCache::Enqueue(std::function<void()> work,
+                            std::function<void()> finish) {
+  tasksInFlight++;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.push_back({std::move(work), std::move(finish)});
+  }
+  wake.notify_one();
+}
+
+void ResourceCache::Update() {
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.swap(finished);
+  }
+  for (std::function<void()> &finish : ready) {
+    finish();
+    tasksInFlight--;
+  }
+
+  // The map holds one reference, so anything at one is unused. Textures
+  // still decoding are also held by their task and survive.
+  for (auto it = textures.begin(); it != textures.end();) {
+    if (it->second.use_count() == 1) {
+      if (it->second->ready)
+        UnloadTexture(it->second->texture);
+      it = textures.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ResourceCache::LoaderLoop() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this] { return stopping || !queued.empty(); });
+      if (stopping)
+        return;
+      task = std::move(queued.front());
+      queued.pop_front();
+    }
+
+    task.work();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finished.push_back(std::move(task.finish));
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "raylib.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct TextureResource {
+  Texture2D texture;
+  bool ready;
+  const Texture2D *placeholder;
+};
+
+// Shared reference to a cached texture. Draws as the cache's placeholder
+// until the decoded image has been uploaded.
+class TextureHandle {
+public:
+  TextureHandle() = default;
+
+  bool IsValid() const { return resource != nullptr; }
+  bool IsReady() const { return resource && resource->ready; }
+  const Texture2D &Get() const {
+    return resource->ready ? resource->texture : *resource->placeholder;
+  }
+
+private:
+  friend class ResourceCache;
+  explicit TextureHandle(std::shared_ptr<TextureResource> resource)
+      : resource(std::move(resource)) {}
+
+  std::shared_ptr<TextureResource> resource;
+};
+
+// Textures keyed by path, shared between every user that asks for the same
+// file. Files are decoded on a loader thread and uploaded to the GPU on the
+// main thread in Update, so startup doesn't block on image decoding.
+// Textures are released once no handle refers to them any more. Everything
+// except the work half of a task runs on the main thread.
+class ResourceCache {
+public:
+  ResourceCache();
+  ~ResourceCache();
+
+  // Disable copy and move operations
+  ResourceCache(const ResourceCache &) = delete;
+  ResourceCache &operator=(const ResourceCache &) = delete;
+  ResourceCache(ResourceCache &&) = delete;
+  ResourceCache &operator=(ResourceCache &&) = delete;
+
+  // Needs the GL context: creates the placeholder and starts the loader
+  void Init();
+  // Stops the loader and unloads every texture, including ones still held
+  void Unload();
+
+  TextureHandle GetTexture(const std::string &path);
+
+  // Runs work on the loader thread, then finish on the main thread from the
+  // next Update after it completes
+  void Enqueue(std::function<void()> work, std::function<void()> finish);
+
+  // Main thread, once per frame: uploads finished decodes, runs finish
+  // callbacks and drops textures nobody holds
+  void Update();
+
+  // True when nothing is queued, decoding or waiting for upload
+  bool IsIdle() const { return tasksInFlight == 0; }
+  const Texture2D &GetPlaceholder() const { return placeholder; }
+
+private:
+  struct Task {
+    std::function<void()> work;
+    std::function<void()> finish;
+  };
+
+  std::unordered_map<std::string, std::shared_ptr<TextureResource>> textures;
+  Texture2D placeholder;
+  int tasksInFlight; // Main thread only
+
+  std::thread loader;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<Task> queued;                    // Guarded by mutex
+  std::vector<std::function<void()>> finished; // Guarded by mutex
+  bool stopping;                              // Guarded by mutex
+
+  void LoaderLoop();
+};
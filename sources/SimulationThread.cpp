@@ -0,0 +1,98 @@
+#include "SimulationThread.h"
+#include "Tracer.h"
+#include <chrono>
+
+// Idle polls before the thread starts sleeping between checks for input
+static const int SPIN_LIMIT = 64;
+
+SimulationThread::SimulationThread(GameWorld &world)
+    : world(world), lastInputTime(-1.0), running(false),
+      pauseRequested(false), parked(false), pauseDepth(0) {
+  PublishSnapshot();
+}
+
+SimulationThread::~SimulationThread() { Stop(); }
+
+void SimulationThread::Start() {
+  if (IsThreaded())
+    return;
+  running.store(true);
+  thread = std::thread(&SimulationThread::Run, this);
+}
+
+void SimulationThread::Stop() {
+  if (!IsThreaded())
+    return;
+  running.store(false);
+  thread.join();
+  pauseRequested.store(false);
+  parked.store(false);
+}
+
+void SimulationThread::SubmitInput(const PlayerInput &input, double time) {
+  if (!IsThreaded()) {
+    Step({input, time});
+    return;
+  }
+  inputs.WriteSlot() = {input, time};
+  inputs.Publish();
+}
+
+const RenderSnapshot &SimulationThread::AcquireSnapshot() {
+  snapshots.Update();
+  return snapshots.ReadSlot();
+}
+
+void SimulationThread::Pause() {
+  if (pauseDepth++ > 0 || !IsThreaded())
+    return;
+  pauseRequested.store(true);
+  while (!parked.load())
+    std::this_thread::yield();
+}
+
+void SimulationThread::Resume() {
+  if (--pauseDepth > 0)
+    return;
+  // The simulation is parked, so the main thread may act as the producer
+  PublishSnapshot();
+  if (IsThreaded())
+    pauseRequested.store(false);
+}
+
+void SimulationThread::Run() {
+  TRACE_THREAD_NAME("simulation");
+  int idlePolls = 0;
+  while (running.load()) {
+    if (pauseRequested.load()) {
+      parked.store(true);
+      while (pauseRequested.load() && running.load())
+        std::this_thread::yield();
+      // Re-check the request before touching the world again
+      parked.store(false);
+      continue;
+    }
+
+    if (inputs.Update()) {
+      Step(inputs.ReadSlot());
+      idlePolls = 0;
+    } else if (++idlePolls < SPIN_LIMIT) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+}
+
+void SimulationThread::Step(const InputPacket &packet) {
+  float dt =
+      (lastInputTime < 0.0) ? 0.0f : (float)(packet.time - lastInputTime);
+  lastInputTime = packet.time;
+  world.Tick(packet.input, dt);
+  PublishSnapshot();
+}
+
+void SimulationThread::PublishSnapshot() {
+  world.WriteSnapshot(snapshots.WriteSlot());
+  snapshots.Publish();
+}
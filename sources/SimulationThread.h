@@ -0,0 +1,81 @@
+#pragma once
+#include "GameWorld.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <thread>
+
+// Runs GameWorld::Tick on a dedicated thread, one tick per submitted frame.
+// The main thread hands over input and reads snapshots through triple
+// buffers, so while it draws frame N the world is already computing tick N
+// and a frame costs max(sim, render) instead of their sum.
+//
+// When the thread isn't started (single core, or --no-sim-thread) the tick
+// runs inline in SubmitInput and the rest of the frame is unchanged.
+class SimulationThread {
+public:
+  explicit SimulationThread(GameWorld &world);
+  ~SimulationThread();
+
+  // Disable copy and move operations
+  SimulationThread(const SimulationThread &) = delete;
+  SimulationThread &operator=(const SimulationThread &) = delete;
+  SimulationThread(SimulationThread &&) = delete;
+  SimulationThread &operator=(SimulationThread &&) = delete;
+
+  void Start();
+  void Stop();
+  bool IsThreaded() const { return thread.joinable(); }
+
+  // Main thread. time is the frame start in seconds; the tick's dt is the
+  // difference to the previous submitted input.
+  void SubmitInput(const PlayerInput &input, double time);
+  // Main thread. Newest published snapshot, valid until the next call.
+  const RenderSnapshot &AcquireSnapshot();
+
+  // Main thread. Parks the simulation between ticks so the world can be
+  // edited directly (node graph edits, restarting a run). Resume publishes
+  // a fresh snapshot so the edit is visible on the same frame.
+  void Pause();
+  void Resume();
+
+private:
+  struct InputPacket {
+    PlayerInput input;
+    double time;
+  };
+
+  GameWorld &world;
+  TripleBuffer<InputPacket> inputs;
+  TripleBuffer<RenderSnapshot> snapshots;
+  double lastInputTime;
+
+  std::thread thread;
+  std::atomic<bool> running;
+  std::atomic<bool> pauseRequested;
+  std::atomic<bool> parked;
+  int pauseDepth;
+
+  void Run();
+  void Step(const InputPacket &packet);
+  void PublishSnapshot();
+};
+
+// Holds the simulation paused for the lifetime of the scope
+class SimulationPause {
+public:
+  explicit SimulationPause(SimulationThread &simulation)
+      : simulation(simulation) {
+    simulation.Pause();
+  }
+  ~SimulationPause() { simulation.Resume(); }
+
+  // Disable copy and move operations
+  SimulationPause(const SimulationPause &) = delete;
+  SimulationPause &operator=(const SimulationPause &) = delete;
+  SimulationPause(SimulationPause &&) = delete;
+  SimulationPause &operator=(SimulationPause &&) = delete;
+
+private:
+  SimulationThread &simulation;
+};
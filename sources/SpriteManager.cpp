@@ -1,46 +1,106 @@
 #include "SpriteManager.h"
+#include "AtlasBuilder.h"
 #include "raylib.h"
+#include <memory>
 
-SpriteManager::SpriteManager() : spritesheet{0} {}
+SpriteManager::SpriteManager() : placeholder(nullptr), loadGeneration(0) {}
 
-void SpriteManager::Init(const char *spritesheetPath,
-                         const Rectangle *collisions,
-                         const NPatchInfo *nPatchInfo) {
-  spritesheet = LoadTexture(spritesheetPath);
+void SpriteManager::Init(const char *assetsDir, const char *cachePath,
+                         ResourceCache &resources) {
+  Unload();
+  placeholder = &resources.GetPlaceholder();
 
-  // Initialize sprite rectangles (assuming horizontal layout)
-  for (int i = 0; i < SPRITE_COUNT; i++) {
-    sprites[i] = Rectangle{static_cast<float>(32 * i), 0.0f, 32.0f, 32.0f};
-    this->collisions[i] = collisions[i];
-    this->nPatchInfo[i] = nPatchInfo[i];
-  }
+  // Reading the cache (or packing the atlas) happens off the main thread
+  auto atlas = std::make_shared<Atlas>();
+  auto loaded = std::make_shared<bool>(false);
+  std::string assets = assetsDir;
+  std::string cache = cachePath;
+  int generation = loadGeneration;
+  resources.Enqueue(
+      [atlas, loaded, assets, cache]() {
+        AtlasBuilder builder(assets);
+        *loaded = builder.LoadOrBuild(cache, *atlas);
+      },
+      [this, atlas, loaded, generation]() {
+        if (generation != loadGeneration)
+          return; // Unloaded while the atlas was loading
+        if (!*loaded) {
+          TraceLog(LOG_WARNING, "SpriteManager: no sprite atlas loaded");
+          return;
+        }
+
+        for (const AtlasPage &page : atlas->pages) {
+          Image image = {(void *)page.pixels.data(), page.width, page.height,
+                         1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+          pages.push_back(LoadTextureFromImage(image));
+        }
+
+        sprites = std::move(atlas->sprites);
+        for (size_t i = 0; i < sprites.size(); i++)
+          spriteIndex[sprites[i].name] = (int)i;
+      });
 }
 
-SpriteManager::~SpriteManager() {
-  if (spritesheet.id != 0) {
-    UnloadTexture(spritesheet);
+void SpriteManager::Unload() {
+  for (const Texture2D &page : pages)
+    if (page.id != 0)
+      UnloadTexture(page);
+  pages.clear();
+  sprites.clear();
+  spriteIndex.clear();
+  loadGeneration++;
+}
+
+SpriteManager::~SpriteManager() { Unload(); }
+
+const AtlasSprite *SpriteManager::GetSprite(const std::string &name) const {
+  auto it = spriteIndex.find(name);
+  return it != spriteIndex.end() ? &sprites[it->second] : nullptr;
+}
+
+void SpriteManager::DrawSprite(const std::string &name, Rectangle dest,
+                               float rotation, Color tint) const {
+  if (!IsLoaded() && placeholder) {
+    Rectangle source = {0, 0, (float)placeholder->width,
+                        (float)placeholder->height};
+    DrawTexturePro(*placeholder, source, dest, Vector2{0.0f, 0.0f}, rotation,
+                   tint);
+    return;
   }
+
+  const AtlasSprite *sprite = GetSprite(name);
+  if (!sprite) {
+    return; // Unknown sprite
+  }
+
+  if (sprite->hasNPatch)
+    DrawTextureNPatch(pages[sprite->page], sprite->nPatch, dest,
+                      Vector2{0.0f, 0.0f}, rotation, tint);
+  else
+    DrawTexturePro(pages[sprite->page], sprite->source, dest,
+                   Vector2{0.0f, 0.0f}, rotation, tint);
 }
 
-void SpriteManager::DrawSprite(SpriteType type, Vector2 position,
+void SpriteManager::DrawSprite(const std::string &name, Vector2 position,
                                float scale) const {
-  int index = static_cast<int>(type);
-  if (index < 0 || index >= SPRITE_COUNT) {
-    return; // Invalid sprite type
+  const AtlasSprite *sprite = GetSprite(name);
+  if (!sprite) {
+    return; // Unknown sprite
   }
 
-  Rectangle destRect = {position.x, position.y, 32.0f * scale, 32.0f * scale};
+  Rectangle destRect = {position.x, position.y, sprite->source.width * scale,
+                        sprite->source.height * scale};
 
-  DrawTexturePro(spritesheet, sprites[index], destRect, Vector2{0.0f, 0.0f},
-                 0.0f, WHITE);
+  DrawTexturePro(pages[sprite->page], sprite->source, destRect,
+                 Vector2{0.0f, 0.0f}, 0.0f, WHITE);
 }
 
 void SpriteManager::DrawDebugSprites() const {
   int total = 0;
-  for (int row = 0; total < SPRITE_COUNT; row++) {
-    for (int col = 0; col < 5 && total < SPRITE_COUNT; col++) {
+  for (int row = 0; total < GetSpriteCount(); row++) {
+    for (int col = 0; col < 5 && total < GetSpriteCount(); col++) {
       DrawSprite(
-          static_cast<SpriteType>(total),
+          sprites[total].name,
           Vector2{static_cast<float>(col * 100), static_cast<float>(row * 100)},
           2.0f);
       total++;
@@ -1,26 +1,18 @@
 #pragma once
+#include "AtlasBuilder.h"
+#include "ResourceCache.h"
 #include "raylib.h"
-
-enum class SpriteType {
-  CPU,
-  ACTION_CHIP,
-  RED_CYLINDER,
-  GREEN_CYLINDER,
-  BROWN_CYLINDER,
-  BLUE_LAMP,
-  RED_LAMP,
-  VACUUM,
-  PLAYER,
-  COUNT // Used to get the total count
-};
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class SpriteManager {
 private:
-  static constexpr int SPRITE_COUNT = static_cast<int>(SpriteType::COUNT);
-  Texture2D spritesheet;
-  Rectangle sprites[SPRITE_COUNT];
-  Rectangle collisions[SPRITE_COUNT];
-  NPatchInfo nPatchInfo[SPRITE_COUNT];
+  std::vector<Texture2D> pages;
+  std::vector<AtlasSprite> sprites;
+  std::unordered_map<std::string, int> spriteIndex;
+  const Texture2D *placeholder;
+  int loadGeneration; // Bumped by Unload so stale loads are discarded
 
 public:
   // Constructor
@@ -35,21 +27,27 @@ public:
   SpriteManager(SpriteManager &&other) = delete;
   SpriteManager &operator=(SpriteManager &&other) = delete;
 
-  void Init(const char *spritesheetPath, const Rectangle *collisions,
-            const NPatchInfo *nPatchInfo);
+  // Loads the packed atlas from cachePath on the cache's loader thread,
+  // rebuilding it from assetsDir when the sources changed. Sprites draw as
+  // the cache's placeholder until the pages are uploaded.
+  void Init(const char *assetsDir, const char *cachePath,
+            ResourceCache &resources);
+  void Unload();
 
-  // Main drawing function
+  // Main drawing functions, sprites are addressed by atlas name.
+  // Nine-patch sprites stretch by their borders to fill dest.
   // To draw Nodes, user Draw from BaseNode
-  void DrawSprite(SpriteType type, Vector2 position, float scale = 1.0f) const;
+  void DrawSprite(const std::string &name, Rectangle dest,
+                  float rotation = 0.0f, Color tint = WHITE) const;
+  void DrawSprite(const std::string &name, Vector2 position,
+                  float scale = 1.0f) const;
 
   // Debug function to display all sprites
   void DrawDebugSprites() const;
 
   // Utility functions
-  bool IsLoaded() const { return spritesheet.id != 0; }
-  int GetSpriteCount() const { return SPRITE_COUNT; }
-  const Rectangle *GetCollisions() const { return collisions; }
-  const NPatchInfo *GetNPatchInfo() const { return nPatchInfo; }
-  const Rectangle *GetSprites() const { return sprites; }
-  Texture2D &GetSpritesheet() { return spritesheet; }
+  bool IsLoaded() const { return !pages.empty(); }
+  int GetSpriteCount() const { return (int)sprites.size(); }
+  const AtlasSprite *GetSprite(const std::string &name) const;
+  const Texture2D &GetPageTexture(int page) const { return pages[page]; }
 };
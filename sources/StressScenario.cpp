@@ -0,0 +1,27 @@
+#include "StressScenario.h"
+#include "BuildSpec.h"
+#include <cmath>
+
+// Seconds per turn of the auto-fire aim
+static const double AIM_TURN_SECONDS = 2.0;
+
+void ApplyStressScenario(const StressOptions &options, GameWorld &world) {
+  world.SetEndlessWave();
+  world.SetEnemyFireRate(options.bulletRate);
+  if (options.randomNodes > 0)
+    PlaceRandomGraph(world, options.randomNodes, options.seed);
+}
+
+PlayerInput ApplyStressInput(const StressOptions &options,
+                             const PlayerInput &input, double time,
+                             int width, int height) {
+  if (!options.autoFire)
+    return input;
+  // Aim at a point circling the arena edge, so shots cover every side
+  float angle = (float)(fmod(time / AIM_TURN_SECONDS, 1.0) * 2.0 * PI);
+  PlayerInput scripted = input;
+  scripted.aimPosition = {width * (0.5f + 0.5f * cosf(angle)),
+                          height * (0.5f + 0.5f * sinf(angle))};
+  scripted.fireHeld = true;
+  return scripted;
+}
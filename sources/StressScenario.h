@@ -0,0 +1,24 @@
+#pragma once
+#include "GameWorld.h"
+#include <cstdint>
+
+// Scripted load for reproducing long sessions: the game starts straight in
+// gameplay with the control panel open, keeps the enemy pool (--enemies)
+// full, optionally wires a large random node graph, and exits after a
+// fixed time with the frame-time histograms.
+struct StressOptions {
+  bool enabled = false;
+  float duration = 60.0f; // Seconds before exiting, 0 runs until closed
+  float bulletRate = 1.0f; // Enemy fire rate multiplier
+  bool autoFire = true;    // Hold fire, sweeping the aim around the arena
+  int randomNodes = 0;     // Random placed nodes, 0 for the starting build
+  uint64_t seed = 1;       // World and node graph, from --seed
+};
+
+// Sets up a freshly initialised world for a stress run
+void ApplyStressScenario(const StressOptions &options, GameWorld &world);
+
+// The player's input with the scripted parts applied. time is in seconds.
+PlayerInput ApplyStressInput(const StressOptions &options,
+                             const PlayerInput &input, double time,
+                             int width, int height);
@@ -0,0 +1,206 @@
+#include "Tracer.h"
+#include "raylib.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Buffers grow a chunk at a time and are capped at about a million events
+// (24 MB) per thread; anything past that is counted and dropped
+const int CHUNK_EVENTS = 4096;
+const size_t MAX_CHUNKS_PER_THREAD = 256;
+
+struct TraceEvent {
+  const char *name;
+  int64_t nanoseconds; // Since the recording started
+  int value;
+  char phase; // 'B', 'E' or 'i', as in the Chrome format
+};
+
+struct TraceChunk {
+  TraceEvent events[CHUNK_EVENTS];
+  int count = 0;
+};
+
+// Written only by its own thread while recording, read only while not
+struct ThreadBuffer {
+  int id;
+  std::string name;
+  std::vector<std::unique_ptr<TraceChunk>> chunks;
+  size_t current = 0; // Chunk being filled
+  long long dropped = 0;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // Buffers outlive their threads, so workers that exit keep their events
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+// Written by Start before the recording flag is raised
+std::chrono::steady_clock::time_point epoch;
+
+Registry &GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+thread_local ThreadBuffer *localBuffer = nullptr;
+
+ThreadBuffer &GetLocalBuffer() {
+  if (!localBuffer) {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.emplace_back(new ThreadBuffer());
+    localBuffer = registry.buffers.back().get();
+    localBuffer->id = (int)registry.buffers.size();
+  }
+  return *localBuffer;
+}
+
+void Record(const char *name, char phase, int value) {
+  int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - epoch)
+                            .count();
+
+  ThreadBuffer &buffer = GetLocalBuffer();
+  if (buffer.chunks.empty() ||
+      buffer.chunks[buffer.current]->count == CHUNK_EVENTS) {
+    if (!buffer.chunks.empty() && buffer.current + 1 < buffer.chunks.size()) {
+      buffer.current++; // Reuse a chunk from an earlier recording
+    } else if (buffer.chunks.size() < MAX_CHUNKS_PER_THREAD) {
+      buffer.chunks.emplace_back(new TraceChunk());
+      buffer.current = buffer.chunks.size() - 1;
+    } else {
+      buffer.dropped++;
+      return;
+    }
+  }
+  TraceChunk &chunk = *buffer.chunks[buffer.current];
+  chunk.events[chunk.count++] = {name, nanoseconds, value, phase};
+}
+
+// Names are literals from the probes, but keep the JSON valid regardless
+void WriteJsonString(FILE *file, const char *text) {
+  fputc('"', file);
+  for (; *text; text++) {
+    if (*text == '"' || *text == '\\')
+      fputc('\\', file);
+    if ((unsigned char)*text >= 0x20)
+      fputc(*text, file);
+  }
+  fputc('"', file);
+}
+
+void WriteEvent(FILE *file, bool first, const TraceEvent &event, int tid) {
+  fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+  WriteJsonString(file, event.name);
+  fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+          event.phase, event.nanoseconds / 1000.0, tid);
+  if (event.phase == 'i')
+    fprintf(file, ",\"s\":\"t\",\"args\":{\"value\":%d}", event.value);
+  fputc('}', file);
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::recording(false);
+
+void Tracer::Start() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto &buffer : registry.buffers) {
+    for (auto &chunk : buffer->chunks)
+      chunk->count = 0;
+    buffer->current = 0;
+    buffer->dropped = 0;
+  }
+  epoch = std::chrono::steady_clock::now();
+  recording.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() { recording.store(false, std::memory_order_release); }
+
+// Probes only get here while recording, though a thread may still be
+// finishing one just after Stop
+void Tracer::Begin(const char *name) { Record(name, 'B', 0); }
+void Tracer::End(const char *name) { Record(name, 'E', 0); }
+void Tracer::Instant(const char *name, int value) {
+  Record(name, 'i', value);
+}
+
+void Tracer::SetThreadName(const char *name) {
+  ThreadBuffer &buffer = GetLocalBuffer();
+  std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+  buffer.name = name;
+}
+
+bool Tracer::WriteChromeJson(const std::string &path) {
+  FILE *file = fopen(path.c_str(), "w");
+  if (!file) {
+    TraceLog(LOG_WARNING, "TRACE: could not write %s", path.c_str());
+    return false;
+  }
+
+  // Scopes still open now, such as the frame that stopped the recording,
+  // are ended here so every begin has its end
+  int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - epoch)
+                    .count();
+  std::vector<const char *> open;
+
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  size_t written = 0;
+  long long dropped = 0;
+  fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  bool first = true;
+  for (const auto &buffer : registry.buffers) {
+    dropped += buffer->dropped;
+    if (!buffer->name.empty()) {
+      fprintf(file,
+              "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+              "\"tid\":%d,\"args\":{\"name\":",
+              first ? "" : ",\n", buffer->id);
+      WriteJsonString(file, buffer->name.c_str());
+      fprintf(file, "}}");
+      first = false;
+    }
+    open.clear();
+    for (const auto &chunk : buffer->chunks) {
+      for (int i = 0; i < chunk->count; i++) {
+        const TraceEvent &event = chunk->events[i];
+        if (event.phase == 'B')
+          open.push_back(event.name);
+        else if (event.phase == 'E' && !open.empty())
+          open.pop_back();
+        WriteEvent(file, first, event, buffer->id);
+        first = false;
+        written++;
+      }
+    }
+    while (!open.empty()) {
+      WriteEvent(file, first, {open.back(), now, 0, 'E'}, buffer->id);
+      open.pop_back();
+      first = false;
+    }
+  }
+  fprintf(file, "\n]}\n");
+  bool ok = ferror(file) == 0;
+  fclose(file);
+
+  if (!ok) {
+    TraceLog(LOG_WARNING, "TRACE: error while writing %s", path.c_str());
+    return false;
+  }
+  TraceLog(LOG_INFO, "TRACE: wrote %zu events to %s", written, path.c_str());
+  if (dropped > 0)
+    TraceLog(LOG_WARNING, "TRACE: %lld events dropped, buffers full",
+             dropped);
+  return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+// Timeline recorder for offline analysis, written as Chrome Trace Event
+// JSON (chrome://tracing, ui.perfetto.dev). Each thread appends to its own
+// buffer without locks, so recording costs a clock read and a store per
+// event; when not recording every probe is one atomic load.
+//
+// The probes below compile to nothing unless RRL_TRACING is defined (the
+// RRL_TRACING CMake option). Names must be string literals or otherwise
+// outlive the recording.
+//
+// Start, Stop and WriteChromeJson must not overlap recording on other
+// threads: call them before those threads start, after they stop or while
+// the simulation is paused.
+class Tracer {
+public:
+  // Drops everything recorded so far and starts recording
+  static void Start();
+  static void Stop();
+  static bool IsRecording() {
+    return recording.load(std::memory_order_relaxed);
+  }
+
+  // Scopes still open, like the frame that stopped the recording, are
+  // ended at the time of writing. Returns false when the file can't be
+  // written.
+  static bool WriteChromeJson(const std::string &path);
+
+  // Probes; see the TRACE_ macros
+  static void Begin(const char *name);
+  static void End(const char *name);
+  static void Instant(const char *name, int value);
+  // Labels the calling thread in the trace
+  static void SetThreadName(const char *name);
+
+private:
+  static std::atomic<bool> recording;
+};
+
+// Begin/end pair around its own lifetime. Scopes already open when the
+// recording starts are left out rather than ended unmatched.
+class TraceScope {
+public:
+  explicit TraceScope(const char *name)
+      : name(name), active(Tracer::IsRecording()) {
+    if (active)
+      Tracer::Begin(name);
+  }
+  ~TraceScope() {
+    if (active)
+      Tracer::End(name);
+  }
+
+  // Disable copy and move operations
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+  TraceScope(TraceScope &&) = delete;
+  TraceScope &operator=(TraceScope &&) = delete;
+
+private:
+  const char *name;
+  bool active;
+};
+
+#ifdef RRL_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+// Arguments are only evaluated while recording
+#define TRACE_INSTANT(name, value)                                             \
+  (Tracer::IsRecording() ? Tracer::Instant(name, value) : (void)0)
+#define TRACE_THREAD_NAME(name) Tracer::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_INSTANT(name, value) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
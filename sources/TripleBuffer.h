@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free handoff of the latest value from one producer thread to one
+// consumer thread. The producer fills WriteSlot() and calls Publish(); the
+// consumer calls Update() and reads ReadSlot(). Neither side ever waits for
+// the other, and intermediate values the consumer didn't pick up in time are
+// simply overwritten.
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() : slots(), middle(1), back(0), front(2) {}
+
+  // Disable copy and move operations
+  TripleBuffer(const TripleBuffer &) = delete;
+  TripleBuffer &operator=(const TripleBuffer &) = delete;
+  TripleBuffer(TripleBuffer &&) = delete;
+  TripleBuffer &operator=(TripleBuffer &&) = delete;
+
+  // Producer side
+  T &WriteSlot() { return slots[back]; }
+  void Publish() {
+    back = middle.exchange(back | FRESH_BIT, std::memory_order_acq_rel) &
+           INDEX_MASK;
+  }
+
+  // Consumer side. Returns true when a newer value was swapped in.
+  bool Update() {
+    if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT))
+      return false;
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+  const T &ReadSlot() const { return slots[front]; }
+
+private:
+  static const uint8_t INDEX_MASK = 0x3;
+  static const uint8_t FRESH_BIT = 0x4;
+
+  T slots[3];
+  std::atomic<uint8_t> middle; // Slot index plus FRESH_BIT
+  uint8_t back;                // Owned by the producer
+  uint8_t front;               // Owned by the consumer
+};
@@ -0,0 +1,84 @@
+#include "UiLayer.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+UiKey &UiKey::Add(const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  return *this;
+}
+
+// Starts at 1 so default-constructed widgets count as never painted
+UiLayer::UiLayer()
+    : target{0}, width(0), height(0), layout(1), cached(true) {}
+
+UiLayer::~UiLayer() { Unload(); }
+
+void UiLayer::Layout(int overlayWidth, int overlayHeight) {
+  width = overlayWidth;
+  height = overlayHeight;
+  layout++;
+}
+
+void UiLayer::Unload() {
+  if (target.id != 0) {
+    UnloadRenderTexture(target);
+    target = {0};
+  }
+}
+
+void UiLayer::SetCached(bool cache) {
+  cached = cache;
+  layout++;
+  if (!cached)
+    Unload();
+}
+
+bool UiLayer::BeginRepaint(UiWidget &widget, uint64_t key) {
+  if (!cached)
+    return true;
+  if (widget.paintedLayout == layout && widget.paintedKey == key)
+    return false;
+  if (target.texture.width != width || target.texture.height != height) {
+    Unload();
+    // Only after a Layout, so every widget repaints into the new texture
+    target = LoadRenderTexture(width, height);
+  }
+  widget.paintedKey = key;
+  widget.paintedLayout = layout;
+
+  BeginTextureMode(target);
+  // Clearing honours the scissor rect, so only this widget is wiped
+  BeginScissorMode((int)widget.rect.x, (int)widget.rect.y,
+                   (int)widget.rect.width, (int)widget.rect.height);
+  ClearBackground(BLANK);
+  EndScissorMode();
+
+  // Blend colour as usual but accumulate alpha, leaving premultiplied
+  // pixels that Draw composites exactly like drawing straight to the
+  // overlay would have
+  rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE,
+                            RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+  BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+  return true;
+}
+
+void UiLayer::EndRepaint() {
+  if (!cached)
+    return;
+  EndBlendMode();
+  EndTextureMode();
+}
+
+void UiLayer::Draw(Rectangle region) const {
+  if (target.id == 0)
+    return;
+  // Render textures are stored bottom-up, hence the flipped source
+  Rectangle source = {region.x,
+                      target.texture.height - region.y - region.height,
+                      region.width, -region.height};
+  BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+  DrawTexturePro(target.texture, source, region, {0, 0}, 0.0f, WHITE);
+  EndBlendMode();
+}
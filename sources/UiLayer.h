@@ -0,0 +1,77 @@
+#pragma once
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+
+// A retained panel region. The owner lays out its rect and, every frame,
+// builds a key from the values the widget shows; the widget is repainted
+// only when that key changes or the layer is laid out again.
+struct UiWidget {
+  Rectangle rect = {0, 0, 0, 0}; // Overlay coordinates
+  uint64_t paintedKey = 0;
+  unsigned int paintedLayout = 0; // UiLayer generation it was painted in
+};
+
+// Builds a widget's content key, 64-bit FNV-1a over the values it draws
+class UiKey {
+public:
+  UiKey &Add(const void *data, size_t size);
+  UiKey &Add(int value) { return Add(&value, sizeof(value)); }
+  UiKey &Add(float value) { return Add(&value, sizeof(value)); }
+  UiKey &Add(uint64_t value) { return Add(&value, sizeof(value)); }
+  UiKey &Add(Vector2 value) { return Add(value.x).Add(value.y); }
+  uint64_t Get() const { return hash; }
+
+private:
+  uint64_t hash = 14695981039346656037ull;
+};
+
+// Cached render texture that widgets repaint into only when dirty; each
+// frame then draws the cached pixels instead of redoing the widget's text,
+// shapes and layout. The texture covers the whole overlay, so widgets
+// paint with the same coordinates, cameras and scissor rects as when they
+// drew straight to it.
+//
+// A repaint clears the widget's rect and nothing else, so a widget must
+// paint its whole rect, background included. Repaints can't nest inside
+// another texture mode, so they happen before the overlay pass.
+//
+// With caching off, every BeginRepaint says yes without binding anything
+// and Draw does nothing, so widgets paint straight into whatever is bound.
+// The owner then has to paint inside the overlay pass, every frame. This
+// is for timing the layer against plain immediate drawing.
+class UiLayer {
+private:
+  RenderTexture2D target;
+  int width;
+  int height;
+  unsigned int layout; // Bumped on every Layout, dirtying every widget
+  bool cached;
+
+public:
+  UiLayer();
+  ~UiLayer();
+
+  // Disable copy and move operations
+  UiLayer(const UiLayer &other) = delete;
+  UiLayer &operator=(const UiLayer &other) = delete;
+  UiLayer(UiLayer &&other) = delete;
+  UiLayer &operator=(UiLayer &&other) = delete;
+
+  // Sizes the layer to the overlay and marks every widget dirty. Only
+  // stores the size; the texture is (re)created on the next repaint.
+  void Layout(int overlayWidth, int overlayHeight);
+  void Unload();
+
+  // Frees the texture when switched off; switching back on repaints all
+  void SetCached(bool cache);
+  bool IsCached() const { return cached; }
+
+  // Returns true, with the layer bound and the widget's rect cleared, when
+  // the widget needs painting under this key; finish with EndRepaint
+  bool BeginRepaint(UiWidget &widget, uint64_t key);
+  void EndRepaint();
+
+  // Draws the cached pixels of a region, usually one widget's rect
+  void Draw(Rectangle region) const;
+};
@@ -0,0 +1,87 @@
+#include "VirtualScreen.h"
+#include "raylib.h"
+#include <cmath>
+
+VirtualScreen::VirtualScreen(int virtualWidth, int virtualHeight)
+    : sceneTarget{0}, overlayTarget{0}, renderScale(1.0f),
+      presentRect{0, 0, (float)virtualWidth, (float)virtualHeight},
+      width(virtualWidth), height(virtualHeight) {}
+
+VirtualScreen::~VirtualScreen() { Unload(); }
+
+void VirtualScreen::Init() {
+  Unload();
+  overlayTarget = LoadRenderTexture(width, height);
+  SetTextureFilter(overlayTarget.texture, TEXTURE_FILTER_BILINEAR);
+  LoadSceneTarget();
+  UpdateLayout();
+}
+
+void VirtualScreen::LoadSceneTarget() {
+  if (sceneTarget.id != 0)
+    UnloadRenderTexture(sceneTarget);
+  sceneTarget = LoadRenderTexture((int)ceilf(width * renderScale),
+                                  (int)ceilf(height * renderScale));
+  SetTextureFilter(sceneTarget.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+void VirtualScreen::Unload() {
+  if (sceneTarget.id != 0) {
+    UnloadRenderTexture(sceneTarget);
+    sceneTarget = {0};
+  }
+  if (overlayTarget.id != 0) {
+    UnloadRenderTexture(overlayTarget);
+    overlayTarget = {0};
+  }
+}
+
+void VirtualScreen::UpdateLayout() {
+  float screenWidth = (float)GetScreenWidth();
+  float screenHeight = (float)GetScreenHeight();
+  float scale = fminf(screenWidth / width, screenHeight / height);
+  presentRect = {floorf((screenWidth - width * scale) / 2.0f),
+                 floorf((screenHeight - height * scale) / 2.0f),
+                 width * scale, height * scale};
+
+  SetMouseOffset(-(int)presentRect.x, -(int)presentRect.y);
+  SetMouseScale(1.0f / scale, 1.0f / scale);
+}
+
+void VirtualScreen::SetRenderScale(float scale) {
+  scale = fminf(fmaxf(scale, 0.25f), 1.0f);
+  if (scale == renderScale)
+    return;
+  renderScale = scale;
+  if (overlayTarget.id != 0)
+    LoadSceneTarget();
+}
+
+void VirtualScreen::BeginScene() {
+  BeginTextureMode(sceneTarget);
+  Camera2D camera = {{0, 0}, {0, 0}, 0.0f, renderScale};
+  BeginMode2D(camera);
+}
+
+void VirtualScreen::EndScene() {
+  EndMode2D();
+  EndTextureMode();
+}
+
+void VirtualScreen::BeginOverlay() {
+  BeginTextureMode(overlayTarget);
+  ClearBackground(BLACK);
+  // Render textures are stored bottom-up, hence the negative source height
+  DrawTexturePro(sceneTarget.texture,
+                 {0, 0, (float)sceneTarget.texture.width,
+                  -(float)sceneTarget.texture.height},
+                 {0, 0, (float)width, (float)height}, {0, 0}, 0.0f, WHITE);
+}
+
+void VirtualScreen::EndOverlay() { EndTextureMode(); }
+
+void VirtualScreen::Present() const {
+  DrawTexturePro(overlayTarget.texture,
+                 {0, 0, (float)width, -(float)height}, presentRect, {0, 0},
+                 0.0f, WHITE);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "raylib.h"
+
+// Renders the game at a fixed virtual resolution and letterboxes the result
+// into the window, so gameplay bounds and UI layout never depend on the
+// window size. Mouse input is remapped to virtual coordinates.
+//
+// Frames are built in two layers:
+//   scene   - gameplay, rendered at virtual size * render scale
+//   overlay - HUD and panels at full virtual size, on top of the scene
+class VirtualScreen {
+private:
+  RenderTexture2D sceneTarget;
+  RenderTexture2D overlayTarget;
+  float renderScale;
+  Rectangle presentRect;
+
+  void LoadSceneTarget();
+
+public:
+  const int width;
+  const int height;
+
+  VirtualScreen(int virtualWidth, int virtualHeight);
+  ~VirtualScreen();
+
+  // Disable copy and move operations
+  VirtualScreen(const VirtualScreen &other) = delete;
+  VirtualScreen &operator=(const VirtualScreen &other) = delete;
+  VirtualScreen(VirtualScreen &&other) = delete;
+  VirtualScreen &operator=(VirtualScreen &&other) = delete;
+
+  // Needs an active GL context
+  void Init();
+  void Unload();
+
+  // Recompute the letterbox and mouse mapping after a window resize
+  void UpdateLayout();
+
+  void BeginScene();
+  void EndScene();
+  void BeginOverlay();
+  void EndOverlay();
+
+  // Call between BeginDrawing and EndDrawing
+  void Present() const;
+
+  // Fraction of the virtual resolution the scene layer is rendered at
+  void SetRenderScale(float scale);
+  float GetRenderScale() const { return renderScale; }
+};
@@ -0,0 +1,146 @@
+#include "WaveDirector.h"
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+// How soon an endless wave starts over to refill the field
+static const float ENDLESS_REFILL = 0.5f;
+
+WaveDirector::WaveDirector()
+    : waveIndex(0), waveNumber(0), spawned(0), spawnClock(0.0f),
+      clearClock(0.0f) {
+  LoadDefaults();
+}
+
+void WaveDirector::LoadDefaults() {
+  archetypes = {
+      {"grunt", 30, 100.0f, 2.0f, "aimed"},
+      {"ringer", 45, 70.0f, 2.5f, "burst"},
+      {"swirler", 60, 60.0f, 1.5f, "swirl"},
+  };
+  waves = {
+      {2, 0, 500.0f, 700.0f, 0.0f, 0.0f},
+      {4, 0, 450.0f, 700.0f, 0.4f, 0.0f},
+      {3, 1, 500.0f, 700.0f, 0.6f, 0.0f},
+      {8, 0, 400.0f, 800.0f, 0.25f, 20.0f},
+      {4, 2, 500.0f, 700.0f, 0.5f, 20.0f},
+      {12, 0, 400.0f, 800.0f, 0.2f, 15.0f},
+  };
+  Reset();
+}
+
+void WaveDirector::LoadEndless(int count) {
+  // Starting over spawns at most the free slots, so the field stays full
+  waves = {{std::max(1, count), 0, 400.0f, 800.0f, 0.0f, ENDLESS_REFILL}};
+  Reset();
+}
+
+bool WaveDirector::Load(const std::string &path) {
+  char *text = LoadFileText(path.c_str());
+  if (!text) {
+    TraceLog(LOG_WARNING, "WAVES: could not read %s", path.c_str());
+    return false;
+  }
+
+  std::vector<EnemyArchetype> loadedArchetypes;
+  std::vector<WaveSpec> loadedWaves;
+  bool valid = true;
+  std::istringstream lines(text);
+  UnloadFileText(text);
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(lines, line)) {
+    lineNumber++;
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword) || keyword[0] == '#')
+      continue;
+
+    bool entryValid = true;
+    if (keyword == "archetype") {
+      EnemyArchetype archetype;
+      entryValid = (tokens >> archetype.name >> archetype.health >>
+                    archetype.speed >> archetype.shootCooldown >>
+                    archetype.pattern) &&
+                   archetype.health > 0 && archetype.shootCooldown > 0.0f;
+      if (entryValid)
+        loadedArchetypes.push_back(archetype);
+    } else if (keyword == "wave") {
+      WaveSpec wave;
+      std::string archetype;
+      entryValid = (bool)(tokens >> wave.count >> archetype >> wave.ringMin >>
+                          wave.ringMax >> wave.interval >> wave.timeout) &&
+                   wave.count > 0 && wave.ringMin >= 0.0f &&
+                   wave.ringMax >= wave.ringMin && wave.interval >= 0.0f &&
+                   wave.timeout >= 0.0f;
+      wave.archetype = -1;
+      for (size_t i = 0; i < loadedArchetypes.size(); i++)
+        if (loadedArchetypes[i].name == archetype)
+          wave.archetype = (int)i;
+      entryValid = entryValid && wave.archetype != -1;
+      if (entryValid)
+        loadedWaves.push_back(wave);
+    } else {
+      TraceLog(LOG_WARNING, "WAVES: %s:%d: unknown entry '%s'", path.c_str(),
+               lineNumber, keyword.c_str());
+      valid = false;
+      continue;
+    }
+
+    if (!entryValid) {
+      TraceLog(LOG_WARNING, "WAVES: %s:%d: malformed %s entry", path.c_str(),
+               lineNumber, keyword.c_str());
+      valid = false;
+    }
+  }
+
+  if (!valid || loadedWaves.empty()) {
+    if (loadedWaves.empty())
+      TraceLog(LOG_WARNING, "WAVES: %s declares no waves", path.c_str());
+    return false;
+  }
+  archetypes = std::move(loadedArchetypes);
+  waves = std::move(loadedWaves);
+  Reset();
+  return true;
+}
+
+void WaveDirector::Reset() {
+  waveIndex = 0;
+  waveNumber = 1;
+  spawned = 0;
+  spawnClock = 0.0f;
+  clearClock = 0.0f;
+}
+
+int WaveDirector::Update(float dt, int liveEnemies, int freeSlots) {
+  const WaveSpec *wave = &waves[waveIndex];
+  if (spawned == wave->count) {
+    clearClock += dt;
+    bool timedOut = wave->timeout > 0.0f && clearClock >= wave->timeout;
+    if (liveEnemies > 0 && !timedOut)
+      return 0;
+    if (waveIndex + 1 < waves.size())
+      waveIndex++;
+    waveNumber++;
+    spawned = 0;
+    spawnClock = 0.0f;
+    clearClock = 0.0f;
+    wave = &waves[waveIndex];
+  } else {
+    spawnClock += dt;
+  }
+
+  // The first enemy of a wave comes out on the tick it starts
+  int due = wave->count - spawned;
+  if (wave->interval > 0.0f) {
+    int released = (int)floorf(spawnClock / wave->interval) + 1;
+    due = std::min(due, released - spawned);
+  }
+  int count = std::min(std::min(due, MAX_SPAWNS_PER_TICK), freeSlots);
+  count = std::max(0, count);
+  spawned += count;
+  return count;
+}
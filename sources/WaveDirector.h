@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Stats an enemy spawns with
+struct EnemyArchetype {
+  std::string name;
+  int health;
+  float speed;
+  float shootCooldown;
+  std::string pattern; // Bullet pattern name, see BulletPattern.h
+};
+
+// One wave: count enemies of an archetype, placed between ringMin and
+// ringMax pixels from the player, one every interval seconds (0 for as
+// fast as the per-tick cap allows). The next wave starts once this one is
+// fully spawned and either cleared or older than timeout (0 waits for the
+// clear).
+struct WaveSpec {
+  int count;
+  int archetype; // Index into the director's archetypes
+  float ringMin;
+  float ringMax;
+  float interval;
+  float timeout;
+};
+
+// Plays waves in file order and repeats the last one forever. Files are
+// plain text; archetypes must be declared before the waves that use them:
+//
+//   # archetype NAME  health  speed  cooldown  pattern
+//   archetype grunt   30      100    2.0       aimed
+//   # wave COUNT ARCHETYPE  ring_min  ring_max  interval  timeout
+//   wave 2 grunt            500       700       0         0
+//
+// The director only decides how many to spawn; the world owns the slots.
+class WaveDirector {
+public:
+  // No wave spawns more than this many enemies in one tick, so big waves
+  // are spread over several frames
+  static const int MAX_SPAWNS_PER_TICK = 32;
+
+  WaveDirector();
+
+  // Returns false when the file can't be read, has malformed entries or
+  // declares no waves; the director keeps its previous waves then
+  bool Load(const std::string &path);
+  // Restores the built-in waves, used when no file is loaded
+  void LoadDefaults();
+  // Replaces the waves with one that keeps count enemies of the first
+  // archetype on the field, refilling slots as they free up
+  void LoadEndless(int count);
+  // Back to the first wave
+  void Reset();
+
+  // Enemies to spawn this tick for the current wave, at most freeSlots.
+  // liveEnemies is the count after this tick's kills.
+  int Update(float dt, int liveEnemies, int freeSlots);
+
+  const WaveSpec &GetCurrentWave() const { return waves[waveIndex]; }
+  const std::vector<EnemyArchetype> &GetArchetypes() const {
+    return archetypes;
+  }
+  // Waves started since Reset, counting the current one
+  int GetWaveNumber() const { return waveNumber; }
+
+private:
+  std::vector<EnemyArchetype> archetypes;
+  std::vector<WaveSpec> waves;
+  size_t waveIndex;
+  int waveNumber;
+  int spawned;      // Enemies of the current wave spawned so far
+  float spawnClock; // Seconds since the current wave started spawning
+  float clearClock; // Seconds since it finished spawning
+};
@@ -1,15 +1,36 @@
 // main.cpp - Refactored with OOP principles
+#include "AllocTracker.h"
+#include "CircleBatch.h"
 #include "CollisionEditor.h"
 #include "ControlPanel.h"
+#include "DynamicResolution.h"
+#include "FrameArena.h"
+#include "FramePacer.h"
+#include "GameWorld.h"
 #include "HUD.h"
 #include "InputDisplay.h"
-#include "NodesController.h"
+#include "JobSystem.h"
+#include "LaunchOptions.h"
+#include "ParticleSystem.h"
 #include "Player.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "ResourceCache.h"
+#include "SimulationThread.h"
 #include "SpriteManager.h"
+#include "StressScenario.h"
+#include "Tracer.h"
+#include "VirtualScreen.h"
 #include "raylib.h"
 #include "raymath.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <ctime>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 //------------------------------------------------------------------------------------
@@ -18,13 +39,6 @@
 #define VIRTUAL_WIDTH 1600
 #define VIRTUAL_HEIGHT 1200
 
-const int PLAYER_SIZE = 20;
-const int ENEMY_SIZE = 25;
-const int BULLET_SPEED = 800;
-const int BULLET_RADIUS = 5;
-const int MAX_BULLETS = 50;
-const int MAX_ENEMIES = 10;
-
 // Custom Colors
 const Color CYAN = {0, 255, 255, 255};
 const Color STAT_ACTION_LINK_COLOR = {128, 0, 128, 255};
@@ -34,64 +48,57 @@ const Color MIDNIGHTBLUE = {25, 25, 112, 255};
 const Color TEAL_CUSTOM = {0, 128, 128, 255};
 const Color VIOLET_CUSTOM = {238, 130, 238, 255};
 
-//------------------------------------------------------------------------------------
-// Enums and Structs
-//------------------------------------------------------------------------------------
-enum class GameState { MAIN_MENU, GAMEPLAY, GAME_OVER };
-
-struct Bullet {
-  Vector2 position;
-  Vector2 velocity;
-  bool active;
-  Color color;
-  int damage;
-  bool fromPlayer;
-};
-
-struct Enemy {
-  Vector2 position;
-  int health;
-  float speed;
-  bool active;
-  float shootCooldown;
-  float currentShootTimer;
-};
-
-class Window {
-public:
-  int width = VIRTUAL_WIDTH;
-  int height = VIRTUAL_HEIGHT;
-
-  void setDimensions() {
-    width = GetRenderWidth();
-    height = GetRenderHeight();
-  };
-};
-
 //------------------------------------------------------------------------------------
 // Global Variables
 //------------------------------------------------------------------------------------
-GameState currentGameState = GameState::MAIN_MENU;
-Player player;
-Bullet bullets[MAX_BULLETS];
-Enemy enemies[MAX_ENEMIES];
-
+GameWorld world(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+SimulationThread simulation(world);
+JobSystem jobSystem;
+// Tick -> HUD and effects, drained every frame
+GameEventQueue notifications(4096);
+Profiler profiler;
+Player &player = world.player;
+
+ResourceCache resources;
 SpriteManager spriteManager;
-NodesController nodesController;
-ControlPanel controlPanel(player, spriteManager);
-Window window;
+CircleBatch circleBatch;
+ParticleSystem particles;
+FrameArena frameArena; // Reset every frame at BeginDrawing
+ControlPanel controlPanel(world.player, spriteManager, world.nodesController,
+                          frameArena);
+VirtualScreen window(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+DynamicResolution dynamicResolution;
+FramePacer framePacer;
 HUD hud;
+bool uiCached = true; // Off with --no-ui-cache
 CollisionEditor collisionEditor;
 InputDisplay inputDisplay;
 
+// Startup timing, reported once from the first frames
+std::chrono::steady_clock::time_point launchTime;
+bool firstFrameLogged = false;
+bool assetsLoadedLogged = false;
+
+// Where F6 and --trace recordings are written
+std::string tracePath = "rrl_trace.json";
+
+// --stress runs: restarted on death, closed once the time is up
+StressOptions stress;
+double stressEndTime = 0.0;
+int stressRestarts = 0;
+
 //------------------------------------------------------------------------------------
 // Function Declarations
 //------------------------------------------------------------------------------------
 void InitGame();
-void UpdateGame(float dt);
-void DrawGame();
+void StartStressRun();
+PlayerInput GatherInput();
+void DrawGame(const RenderSnapshot &snapshot);
+void PaintGameUi(const RenderSnapshot &snapshot);
+void EmitEventEffects(const GameEvent &event);
+void ToggleTrace();
 void UpdateDrawFrame();
-void SpawnEnemy();
+void LogStartupMilestones();
 bool AreColorsEqual(Color c1, Color c2);
 
 //------------------------------------------------------------------------------------
@@ -100,28 +107,126 @@ bool AreColorsEqual(Color c1, Color c2);
 
 bool firstRender = false;
 
-const Rectangle collisions[] = {
-    {4, 3, 24, 26},   {35, 3, 24, 26},   {74, 5, 12, 21},
-    {106, 3, 24, 26}, {138, 3, 24, 26},  {172, 10, 7, 14},
-    {204, 3, 24, 26}, {224, 10, 32, 12}, {257, 3, 11, 26}};
-const NPatchInfo nPatchInfo[] = {
-    {{4, 3, 24, 26}, 2, 2, 2, 2, NPATCH_NINE_PATCH},
-    {{35, 3, 24, 26}, 2, 2, 2, 2, NPATCH_NINE_PATCH}};
+int main(int argc, char **argv) {
+  launchTime = std::chrono::steady_clock::now();
+  LaunchOptions options;
+  if (!ParseLaunchOptions(argc, argv, options))
+    return 1;
+
+  // Headless runs never open a window
+  if (!options.batch.buildPath.empty()) {
+    options.batch.workerCount = options.workerCount;
+    options.batch.width = VIRTUAL_WIDTH;
+    options.batch.height = VIRTUAL_HEIGHT;
+    return RunBatch(options.batch);
+  }
+  if (!options.suggestPath.empty()) {
+    options.search.firstSeed = options.batch.firstSeed;
+    if (options.batch.duration > 0.0f)
+      options.search.evalDuration = options.batch.duration;
+    options.search.width = VIRTUAL_WIDTH;
+    options.search.height = VIRTUAL_HEIGHT;
+    return RunBuildSearch(options.suggestPath, options.batch.outputPath,
+                          options.search, options.workerCount);
+  }
+
+#ifdef RRL_TRACING
+  TRACE_THREAD_NAME("main");
+  if (!options.tracePath.empty()) {
+    tracePath = options.tracePath;
+    Tracer::Start();
+  }
+#else
+  if (!options.tracePath.empty())
+    TraceLog(LOG_WARNING, "TRACE: built without RRL_TRACING, --trace ignored");
+#endif
+  if (options.allocSampleInterval > 0) {
+    if (AllocTracker::IsEnabled())
+      AllocTracker::SetSampleInterval(options.allocSampleInterval);
+    else
+      TraceLog(LOG_WARNING, "ALLOC: built without RRL_ALLOC_TRACKING, "
+                            "--alloc-sample ignored");
+  }
 
-int main() {
   SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_HIGHDPI);
 
   InitWindow(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, "rrl - v0.0.3");
-  SetTargetFPS(60);
-
-  spriteManager.Init("../assets/spritesheet.png", collisions, nPatchInfo);
-  collisionEditor.AddSprite("General", "../assets/spritesheet.png");
-
-  InitGame();
-  while (!WindowShouldClose()) {
+  framePacer.SetMode(options.pacingMode, options.targetFps);
+
+  // Assets decode on the cache's loader thread while the first frames run
+  resources.Init();
+  spriteManager.Init("../assets/", "atlas.cache", resources);
+  collisionEditor.AddSprite("General",
+                            resources.GetTexture("../assets/spritesheet.png"));
+  circleBatch.Init();
+  window.Init();
+  uiCached = options.uiCache;
+  hud.SetCached(uiCached);
+  controlPanel.SetCached(uiCached);
+
+  // Leave a core for the render thread; the tick thread counts as a worker
+  int workerCount = options.workerCount;
+  if (workerCount <= 0)
+    workerCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+  jobSystem.SetWorkerCount(workerCount);
+  world.SetJobSystem(&jobSystem);
+  world.SetNotificationQueue(&notifications);
+  world.SetProfiler(&profiler);
+
+  std::vector<BulletPattern> patterns;
+  if (LoadBulletPatterns("../assets/patterns.txt", patterns))
+    world.SetBulletPatterns(patterns);
+  world.LoadWaves("../assets/waves.txt");
+
+  stress = options.stress;
+  stress.seed = options.batch.firstSeed;
+  world.Seed(stress.enabled ? stress.seed : (uint64_t)time(nullptr));
+  {
+    SimulationPause pause(simulation);
+    if (options.enemyCapacity > 0)
+      world.SetEnemyCapacity(options.enemyCapacity);
+    if (stress.enabled)
+      StartStressRun();
+    else
+      InitGame();
+  }
+  if (options.simulationThread && std::thread::hardware_concurrency() > 1)
+    simulation.Start();
+  if (stress.enabled && stress.duration > 0.0f)
+    stressEndTime = GetTime() + stress.duration;
+  while (!WindowShouldClose() &&
+         (stressEndTime == 0.0 || GetTime() < stressEndTime)) {
     UpdateDrawFrame();
   }
+  simulation.Stop();
+  if (Tracer::IsRecording()) {
+    Tracer::Stop();
+    Tracer::WriteChromeJson(tracePath);
+  }
+  circleBatch.Unload();
+  hud.Unload();
+  controlPanel.Unload();
+  window.Unload();
+  spriteManager.Unload();
+  resources.Unload();
   CloseWindow();
+
+  if (stress.enabled) {
+    TraceLog(LOG_INFO, "STRESS: %d enemies, %d random nodes, %d restarts",
+             world.enemies.GetCapacity(), stress.randomNodes,
+             stressRestarts);
+    // Scripted runs always report, on stdout unless a file was named
+    if (options.frameStatsPath.empty())
+      options.frameStatsPath = "-";
+  }
+  if (!options.frameStatsPath.empty() &&
+      !framePacer.DumpStats(options.frameStatsPath.c_str()))
+    TraceLog(LOG_WARNING, "Could not write frame stats to %s",
+             options.frameStatsPath.c_str());
+  TraceLog(LOG_INFO, "FRAME ARENA: peak %zu bytes in a frame, %d overflows",
+           frameArena.GetHighWaterMark(), frameArena.GetOverflowCount());
+  if (AllocTracker::IsSampling())
+    AllocTracker::PrintTopSites(stdout, 10);
   return 0;
 }
 
@@ -132,264 +237,304 @@ bool AreColorsEqual(Color c1, Color c2) {
   return (c1.r == c2.r && c1.g == c2.g && c1.b == c2.b && c1.a == c2.a);
 }
 
+// Caller must hold the simulation paused
 void InitGame() {
-  nodesController.Initialize();
-  player = Player();
-
+  world.Init();
+  particles.Clear();
   controlPanel.Initialize(window.width, window.height);
-
-  // Create initial CPU core node
-  auto coreNode = nodesController.CreateNodeFromTemplate(NodeType::CPU_CORE);
-  coreNode->panelPosition = {0, 0};
-  coreNode->isPlaced = true;
-  coreNode->isActive = true;
-  player.placedNodes.push_back(std::move(coreNode));
-
-  // Add initial inventory nodes
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::STAT_HEALTH));
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::POWER_VALUE_ADD));
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::ACTION_FIRE));
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::STAT_DAMAGE));
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::POWER_DURATION_REDUCE));
-  player.inventoryNodes.push_back(
-      nodesController.CreateNodeFromTemplate(NodeType::ACTION_SHIELD));
-
-  for (int i = 0; i < MAX_BULLETS; i++)
-    bullets[i].active = false;
-  for (int i = 0; i < MAX_ENEMIES; i++)
-    enemies[i].active = false;
-
-  SpawnEnemy();
-  SpawnEnemy();
-
-  nodesController.UpdateNodeActivation(player);
-  player.currentHealth = player.maxHealth;
   controlPanel.SetOpen(false);
 }
 
-void SpawnEnemy() {
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    if (!enemies[i].active) {
-      enemies[i].active = true;
-      enemies[i].position = {(float)GetRandomValue(50, window.width - 50),
-                             (float)GetRandomValue(50, 150)};
-      enemies[i].health = 30;
-      enemies[i].speed = 100.0f;
-      enemies[i].shootCooldown = 2.0f;
-      enemies[i].currentShootTimer = (float)GetRandomValue(0, 200) / 100.0f;
-      return;
-    }
-  }
+// Straight into gameplay with the panel open. Caller must hold the
+// simulation paused.
+void StartStressRun() {
+  InitGame();
+  ApplyStressScenario(stress, world);
+  controlPanel.SetOpen(true);
+  world.state = GameState::GAMEPLAY;
 }
 
-void UpdateGame(float gameDt) {
-  // Player movement
-  Vector2 moveDir = {0.0f, 0.0f};
-
+PlayerInput GatherInput() {
+  PlayerInput input = {};
   if (IsKeyDown(KEY_W))
-    moveDir.y -= 1.0f;
+    input.moveDir.y -= 1.0f;
   if (IsKeyDown(KEY_S))
-    moveDir.y += 1.0f;
+    input.moveDir.y += 1.0f;
   if (IsKeyDown(KEY_A))
-    moveDir.x -= 1.0f;
+    input.moveDir.x -= 1.0f;
   if (IsKeyDown(KEY_D))
-    moveDir.x += 1.0f;
-
-  if (moveDir.x != 0.0f || moveDir.y != 0.0f) {
-    float length = sqrtf(moveDir.x * moveDir.x + moveDir.y * moveDir.y);
-    moveDir.x /= length;
-    moveDir.y /= length;
-  }
+    input.moveDir.x += 1.0f;
+
+  input.aimPosition = GetMousePosition();
+  input.fireHeld = IsMouseButtonDown(MOUSE_LEFT_BUTTON) &&
+                   (input.aimPosition.x < controlPanel.GetPanelArea().x ||
+                    !controlPanel.IsOpen());
+  if (stress.enabled)
+    input = ApplyStressInput(stress, input, GetTime(), world.GetWidth(),
+                             world.GetHeight());
+  return input;
+}
 
-  player.position.x += moveDir.x * player.currentSpeed * gameDt;
-  player.position.y += moveDir.y * player.currentSpeed * gameDt;
-
-  player.position.x = Clamp(player.position.x, (float)PLAYER_SIZE,
-                            (float)window.width - PLAYER_SIZE);
-  player.position.y = Clamp(player.position.y, (float)PLAYER_SIZE,
-                            (float)window.height - PLAYER_SIZE);
-
-  // Player manual shooting
-  player.fireCooldownTimer -= gameDt;
-  if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && player.fireCooldownTimer <= 0) {
-    Vector2 mousePos = GetMousePosition();
-    if (mousePos.x < controlPanel.GetPanelArea().x || !controlPanel.IsOpen()) {
-      for (int i = 0; i < MAX_BULLETS; i++) {
-        if (!bullets[i].active) {
-          bullets[i].active = true;
-          bullets[i].fromPlayer = true;
-          bullets[i].position = player.position;
-          Vector2 direction =
-              Vector2Normalize(Vector2Subtract(mousePos, player.position));
-          if (Vector2LengthSqr(direction) == 0)
-            direction = {0, -1};
-          bullets[i].velocity = Vector2Scale(direction, BULLET_SPEED);
-          bullets[i].color = YELLOW;
-          bullets[i].damage = player.currentDamage;
-          player.fireCooldownTimer = player.currentFireRate;
-          break;
-        }
-      }
-    }
+void DrawGame(const RenderSnapshot &snapshot) {
+  // Draw bullets
+  circleBatch.Begin();
+  for (const SnapshotBullet &bullet : snapshot.bullets)
+    circleBatch.Add(bullet.position, BULLET_RADIUS, bullet.color);
+  circleBatch.End();
+
+  // Draw enemies, bodies first so the health labels don't split the batch
+  circleBatch.Begin();
+  for (const SnapshotEnemy &enemy : snapshot.enemies)
+    circleBatch.Add(enemy.position, ENEMY_SIZE, MAROON);
+  circleBatch.End();
+
+  {
+    ProfileScope scope(&profiler, ProfileZone::PARTICLES);
+    particles.Draw(circleBatch);
   }
 
-  // Update node system
-  nodesController.UpdateActionSystem(player, bullets, gameDt);
-  player.applyNodeEffects();
-
-  // Update bullets
-  for (int i = 0; i < MAX_BULLETS; i++) {
-    if (bullets[i].active) {
-      bullets[i].position = Vector2Add(
-          bullets[i].position, Vector2Scale(bullets[i].velocity, gameDt));
-      if (bullets[i].position.x < 0 || bullets[i].position.x > window.width ||
-          bullets[i].position.y < 0 || bullets[i].position.y > window.height) {
-        bullets[i].active = false;
-      }
-    }
+  for (const SnapshotEnemy &enemy : snapshot.enemies) {
+    const char *label = TextFormat("%d", enemy.health);
+    DrawText(label, (int)(enemy.position.x - MeasureText(label, 10) / 2.0f),
+             (int)(enemy.position.y - ENEMY_SIZE - 12), 10, WHITE);
   }
 
-  // Update enemies
-  int activeEnemies = 0;
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    if (enemies[i].active) {
-      activeEnemies++;
-      Vector2 directionToPlayer = Vector2Normalize(
-          Vector2Subtract(player.position, enemies[i].position));
-      if (Vector2Distance(player.position, enemies[i].position) >
-          PLAYER_SIZE + ENEMY_SIZE) {
-        enemies[i].position = Vector2Add(
-            enemies[i].position,
-            Vector2Scale(directionToPlayer, enemies[i].speed * gameDt));
-      }
-
-      // Bullet vs enemy collision
-      for (int b = 0; b < MAX_BULLETS; b++) {
-        if (bullets[b].active && bullets[b].fromPlayer) {
-          if (CheckCollisionCircles(enemies[i].position, ENEMY_SIZE,
-                                    bullets[b].position, BULLET_RADIUS)) {
-            enemies[i].health -= bullets[b].damage;
-            bullets[b].active = false;
-            if (enemies[i].health <= 0) {
-              enemies[i].active = false;
-              NodeType typesToDrop[] = {
-                  NodeType::STAT_HEALTH,    NodeType::STAT_SPEED,
-                  NodeType::STAT_DAMAGE,    NodeType::ACTION_FIRE,
-                  NodeType::ACTION_SHIELD,  NodeType::ACTION_SHIFT,
-                  NodeType::STAT_FIRE_RATE, NodeType::POWER_DURATION_REDUCE,
-                  NodeType::POWER_VALUE_ADD};
-              player.inventoryNodes.push_back(
-                  nodesController.CreateNodeFromTemplate(
-                      typesToDrop[GetRandomValue(
-                          0, sizeof(typesToDrop) / sizeof(NodeType) - 1)]));
-              break;
-            }
-          }
-        }
-      }
+  // Draw player
+  DrawCircleV(snapshot.playerPosition, PLAYER_SIZE,
+              snapshot.playerShieldIsActive ? SKYBLUE : LIME);
+  if (snapshot.playerShieldIsActive)
+    DrawCircleLines((int)snapshot.playerPosition.x,
+                    (int)snapshot.playerPosition.y, PLAYER_SIZE + 3,
+                    ColorAlpha(BLUE, 0.5f));
+}
 
-      // Player vs enemy collision
-      if (CheckCollisionCircles(player.position, PLAYER_SIZE,
-                                enemies[i].position, ENEMY_SIZE)) {
-        if (!player.playerShieldIsActive) {
-          player.currentHealth -= 10;
-          if (player.currentHealth <= 0)
-            currentGameState = GameState::GAME_OVER;
-        }
-      }
-    }
-  }
+// Without the cache this draws the HUD and panel straight to the overlay,
+// so it runs inside the overlay pass instead of before it
+void PaintGameUi(const RenderSnapshot &snapshot) {
+  GameState state = snapshot.state;
+  if (state != GameState::GAMEPLAY && state != GameState::GAME_OVER)
+    return;
+  hud.PaintGameHUD(snapshot, player, controlPanel.IsOpen(), window.width,
+                   window.height);
+  if (state == GameState::GAMEPLAY)
+    controlPanel.Paint(snapshot);
+}
 
-  if (activeEnemies == 0 && currentGameState == GameState::GAMEPLAY) {
-    SpawnEnemy();
-    SpawnEnemy();
+void EmitEventEffects(const GameEvent &event) {
+  switch (event.type) {
+  case GameEventType::ENEMY_KILLED:
+    particles.Emit({event.position, ORANGE, 48, 320.0f, 0.7f, 4.0f, false});
+    particles.Emit({event.position, MAROON, 16, 120.0f, 0.5f, 6.0f, false});
+    break;
+  case GameEventType::ENEMY_HIT:
+    particles.Emit({event.position, YELLOW, 6, 200.0f, 0.25f, 2.0f, false});
+    break;
+  case GameEventType::PLAYER_HIT:
+    particles.Emit({event.position, RED, 12, 240.0f, 0.35f, 3.0f, false});
+    break;
+  case GameEventType::ACTION_STARTED:
+    if (event.nodeType == NodeType::ACTION_FIRE)
+      particles.Emit({event.position, ORANGE, 20, 360.0f, 0.3f, 3.0f, false});
+    else if (event.nodeType == NodeType::ACTION_SHIELD)
+      particles.Emit({event.position, SKYBLUE, 40, 140.0f, 0.45f, 3.0f, true});
+    else if (event.nodeType == NodeType::ACTION_SHIFT)
+      particles.Emit({event.position, LIME, 24, 220.0f, 0.4f, 2.5f, true});
+    else if (event.nodeType == NodeType::ACTION_BURST)
+      particles.Emit({event.position, GOLD, 12, 300.0f, 0.25f, 2.5f, false});
+    break;
+  case GameEventType::NODE_DROPPED:
+    break;
   }
 }
 
-void DrawGame() {
-  // Draw bullets
-  for (int i = 0; i < MAX_BULLETS; i++)
-    if (bullets[i].active)
-      DrawCircleV(bullets[i].position, BULLET_RADIUS, bullets[i].color);
-
-  // Draw enemies
-  for (int i = 0; i < MAX_ENEMIES; i++) {
-    if (enemies[i].active) {
-      DrawCircleV(enemies[i].position, ENEMY_SIZE, MAROON);
-      DrawText(
-          TextFormat("%d", enemies[i].health),
-          (int)(enemies[i].position.x -
-                MeasureText(TextFormat("%d", enemies[i].health), 10) / 2.0f),
-          (int)(enemies[i].position.y - ENEMY_SIZE - 12), 10, WHITE);
-    }
+// Starts a recording, or stops the running one and writes it out
+void ToggleTrace() {
+#ifdef RRL_TRACING
+  SimulationPause pause(simulation);
+  if (!Tracer::IsRecording()) {
+    Tracer::Start();
+    hud.AddNotification("Tracing, F6 to stop", ORANGE);
+  } else {
+    Tracer::Stop();
+    if (Tracer::WriteChromeJson(tracePath))
+      hud.AddNotification(TextFormat("Trace written to %s", tracePath.c_str()),
+                          ORANGE);
   }
-
-  // Draw player
-  DrawCircleV(player.position, PLAYER_SIZE,
-              player.playerShieldIsActive ? SKYBLUE : LIME);
-  if (player.playerShieldIsActive)
-    DrawCircleLines((int)player.position.x, (int)player.position.y,
-                    PLAYER_SIZE + 3, ColorAlpha(BLUE, 0.5f));
-
-  // Draw HUD
-  hud.DrawGameHUD(player, controlPanel.IsOpen(), window.width, window.height);
+#endif
 }
 
 void UpdateDrawFrame() {
-  float dt = GetFrameTime();
+  TRACE_SCOPE("frame");
+  float dt = framePacer.BeginFrame();
+  double frameStart = GetTime();
+
+  resources.Update();
 
   if (IsWindowResized()) {
-    window.setDimensions();
+    window.UpdateLayout();
+  }
+
+  if (IsKeyPressed(KEY_F3)) {
+    dynamicResolution.SetEnabled(!dynamicResolution.IsEnabled());
+  }
+
+  if (IsKeyPressed(KEY_F4)) {
+    profiler.SetVisible(!profiler.IsVisible());
+  }
+
+  if (IsKeyPressed(KEY_F5)) {
+    framePacer.CycleMode();
+  }
+
+  if (IsKeyPressed(KEY_F6)) {
+    ToggleTrace();
   }
 
   if (IsKeyPressed(KEY_TAB)) {
     controlPanel.SetOpen(!controlPanel.IsOpen());
-    if (controlPanel.IsOpen())
+    if (controlPanel.IsOpen()) {
       controlPanel.Initialize(window.width, window.height);
-    else
+    } else {
+      SimulationPause pause(simulation);
       player.applyNodeEffects();
+    }
   }
 
-  if (currentGameState == GameState::GAMEPLAY) {
-    UpdateGame(dt);
+  // With the simulation thread running, this starts the tick for this frame
+  // while the rest of the frame draws the previous one
+  simulation.SubmitInput(GatherInput(), frameStart);
+  const RenderSnapshot *snapshot = &simulation.AcquireSnapshot();
+
+  if (snapshot->state == GameState::GAMEPLAY) {
     if (controlPanel.IsOpen()) {
-      controlPanel.Update(player, dt);
-      // Update node activations after any drag and drop operations
-      nodesController.UpdateNodeActivation(player);
+      if (controlPanel.WillEditGraph()) {
+        SimulationPause pause(simulation);
+        controlPanel.Update(*snapshot, dt);
+        // Update node activations after any drag and drop operations
+        world.nodesController.UpdateNodeActivation(player);
+      } else {
+        controlPanel.Update(*snapshot, dt);
+      }
     }
-  } else if (currentGameState == GameState::MAIN_MENU ||
-             currentGameState == GameState::GAME_OVER) {
+  } else if (stress.enabled && snapshot->state == GameState::GAME_OVER) {
+    // Deaths would end the load, so a stress run just starts over
+    SimulationPause pause(simulation);
+    StartStressRun();
+    stressRestarts++;
+  } else if (snapshot->state == GameState::MAIN_MENU ||
+             snapshot->state == GameState::GAME_OVER) {
     if (IsKeyPressed(KEY_ENTER)) {
+      SimulationPause pause(simulation);
       InitGame();
-      currentGameState = GameState::GAMEPLAY;
-      controlPanel.SetOpen(false);
+      world.state = GameState::GAMEPLAY;
     }
   }
 
+  // Pick up whatever the simulation published in the meantime
+  snapshot = &simulation.AcquireSnapshot();
+  GameState state = snapshot->state;
+
+  GameEvent event;
+  while (notifications.TryPop(event)) {
+    EmitEventEffects(event);
+    if (event.type != GameEventType::NODE_DROPPED)
+      continue;
+    if (BaseNode *templateNode =
+            world.nodesController.GetTemplate(event.nodeType))
+      hud.AddNotification(TextFormat("+ %s", templateNode->name.c_str()),
+                          templateNode->color);
+  }
+  hud.UpdateNotifications(dt);
+  {
+    ProfileScope scope(&profiler, ProfileZone::PARTICLES);
+    particles.Update(dt);
+  }
+
   collisionEditor.Step();
   inputDisplay.Update();
 
-  BeginDrawing();
+  // Gameplay layer, at the dynamic render scale
+  window.BeginScene();
   ClearBackground(BLACK);
+  if (state == GameState::GAMEPLAY || state == GameState::GAME_OVER) {
+    ProfileScope scope(&profiler, ProfileZone::DRAW);
+    DrawGame(*snapshot);
+  }
+  window.EndScene();
+
+  // The HUD and panel keep cached layers; whatever changed is repainted
+  // here, as that can't happen inside the overlay's texture mode
+  if (uiCached) {
+    ProfileScope scope(&profiler, ProfileZone::UI);
+    PaintGameUi(*snapshot);
+  }
 
-  if (currentGameState == GameState::GAMEPLAY) {
-    DrawGame();
+  // UI layer, always at full virtual resolution
+  window.BeginOverlay();
+  if (state == GameState::GAMEPLAY) {
+    ProfileScope scope(&profiler, ProfileZone::UI);
+    if (!uiCached)
+      PaintGameUi(*snapshot);
+    hud.DrawGameHUD();
     if (controlPanel.IsOpen())
-      controlPanel.Draw(player);
-  } else if (currentGameState == GameState::MAIN_MENU) {
+      controlPanel.Draw(*snapshot);
+  } else if (state == GameState::MAIN_MENU) {
     hud.DrawMainMenu(window.width, window.height);
-  } else if (currentGameState == GameState::GAME_OVER) {
-    DrawGame();
+  } else if (state == GameState::GAME_OVER) {
+    if (!uiCached)
+      PaintGameUi(*snapshot);
+    hud.DrawGameHUD();
     hud.DrawGameOver(window.width, window.height);
   }
 
   collisionEditor.Draw();
   inputDisplay.Draw();
+  if (dynamicResolution.IsEnabled())
+    DrawText(TextFormat("Render scale: %d%% (F3)",
+                        (int)(window.GetRenderScale() * 100.0f)),
+             10, window.height - 55, 15, LIGHTGRAY);
+  if (profiler.IsVisible()) {
+    profiler.Draw(10, window.height - 220);
+    DrawText(TextFormat("frame arena: %zu KB, peak %zu KB, %d overflows",
+                        frameArena.GetUsed() / 1024,
+                        frameArena.GetHighWaterMark() / 1024,
+                        frameArena.GetOverflowCount()),
+             10, window.height - 240, 10, LIGHTGRAY);
+  }
+  window.EndOverlay();
+
+  frameArena.Reset();
+  BeginDrawing();
+  ClearBackground(BLACK);
+  window.Present();
 
-  EndDrawing();
+  {
+    TRACE_SCOPE("present");
+    EndDrawing();
+    framePacer.EndFrame();
+  }
+  // Pick next frame's scene scale once this one is on screen, so GPU time
+  // that held up the swap counts too
+  window.SetRenderScale(dynamicResolution.Update(
+      framePacer.GetPresentInterval(), framePacer.GetWorkTime()));
+  profiler.EndFrame(dt);
+  LogStartupMilestones();
+}
+
+void LogStartupMilestones() {
+  if (firstFrameLogged && assetsLoadedLogged)
+    return;
+
+  double elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - launchTime)
+                         .count();
+  if (!firstFrameLogged) {
+    TraceLog(LOG_INFO, "STARTUP: First interactive frame after %.1f ms",
+             elapsedMs);
+    firstFrameLogged = true;
+  }
+  if (!assetsLoadedLogged && resources.IsIdle()) {
+    TraceLog(LOG_INFO, "STARTUP: All assets loaded after %.1f ms", elapsedMs);
+    assetsLoadedLogged = true;
+  }
 }